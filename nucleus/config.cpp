@@ -6,6 +6,7 @@
 #include "config.h"
 #include "nucleus/loader/loader.h"
 
+#include <cstdlib>
 #include <cstring>
 
 // Global configuration object
@@ -21,6 +22,54 @@ void Config::parseArguments(int argc, char** argv)
         if (!strcmp(argv[i], "--debugger")) {
             debugger = true;
         }
+        if (!strncmp(argv[i], "--ppu-cache=", 12)) {
+            ppuCachePath = argv[i] + 12;
+        }
+        if (!strncmp(argv[i], "--ppu-threads=", 14)) {
+            ppuCompilerThreads = atoi(argv[i] + 14);
+        }
+        if (!strcmp(argv[i], "--ppu-translator=interpreter")) {
+            ppuTranslator = PPU_TRANSLATOR_INTERPRETER;
+        }
+        if (!strcmp(argv[i], "--ppu-translator=recompiler")) {
+            ppuTranslator = PPU_TRANSLATOR_RECOMPILER;
+        }
+        if (!strcmp(argv[i], "--ppu-translator=tiered")) {
+            ppuTranslator = PPU_TRANSLATOR_TIERED;
+        }
+        if (!strncmp(argv[i], "--ppu-tier-threshold=", 21)) {
+            ppuTierThreshold = atoi(argv[i] + 21);
+        }
+        if (!strncmp(argv[i], "--ppu-tier2-threshold=", 22)) {
+            ppuTier2Threshold = atoi(argv[i] + 22);
+        }
+        if (!strcmp(argv[i], "--ppu-instrumentation=none")) {
+            ppuInstrumentation = PPU_INSTRUMENTATION_NONE;
+        }
+        if (!strcmp(argv[i], "--ppu-instrumentation=profile")) {
+            ppuInstrumentation = PPU_INSTRUMENTATION_PROFILE;
+        }
+        if (!strcmp(argv[i], "--ppu-instrumentation=trace")) {
+            ppuInstrumentation = PPU_INSTRUMENTATION_TRACE;
+        }
+        if (!strcmp(argv[i], "--ppu-float-accuracy=accurate")) {
+            ppuFloatAccuracy = PPU_FLOAT_ACCURATE;
+        }
+        if (!strcmp(argv[i], "--ppu-float-accuracy=lazy")) {
+            ppuFloatAccuracy = PPU_FLOAT_LAZY;
+        }
+        if (!strcmp(argv[i], "--ppu-float-accuracy=fast")) {
+            ppuFloatAccuracy = PPU_FLOAT_FAST;
+        }
+        if (!strncmp(argv[i], "--ppu-lazy-flags=", 17)) {
+            ppuLazyFlags = atoi(argv[i] + 17) != 0;
+        }
+        if (!strncmp(argv[i], "--ppu-block-dispatch=", 21)) {
+            ppuBlockDispatch = atoi(argv[i] + 21) != 0;
+        }
+        if (!strncmp(argv[i], "--ppu-spin-detection=", 21)) {
+            ppuSpinDetection = atoi(argv[i] + 21) != 0;
+        }
     }
 
     // Check if booting an executable was requested
@@ -19,6 +19,19 @@ enum ConfigLanguage {
 enum ConfigPpuTranslator {
     PPU_TRANSLATOR_INTERPRETER,
     PPU_TRANSLATOR_RECOMPILER,
+    PPU_TRANSLATOR_TIERED,     // Interpret first and recompile hot functions in the background
+};
+
+enum ConfigPpuFloatAccuracy {
+    PPU_FLOAT_ACCURATE,  // Compute FPSCR[FPRF] after every instruction
+    PPU_FLOAT_LAZY,      // Compute FPSCR[FPRF] only when it is read
+    PPU_FLOAT_FAST,      // Never compute FPSCR[FPRF] and map VSCR[NJ] to the host denormal flushing
+};
+
+enum ConfigPpuInstrumentation {
+    PPU_INSTRUMENTATION_NONE,     // Recompiled code is not instrumented
+    PPU_INSTRUMENTATION_PROFILE,  // Count calls and cycles of each recompiled function
+    PPU_INSTRUMENTATION_TRACE,    // Print the name and arguments of each recompiled function called
 };
 
 enum ConfigSpuTranslator {
@@ -45,6 +58,15 @@ public:
     // Saved settings
     ConfigLanguage language = LANGUAGE_DEFAULT;
     ConfigPpuTranslator ppuTranslator = PPU_TRANSLATOR_INTERPRETER;
+    bool ppuBlockDispatch = true;  // Interpreter checks for events only between basic blocks
+    bool ppuLazyFlags = true;      // Interpreter computes CR0 and XER[CA] only when they are read
+    ConfigPpuFloatAccuracy ppuFloatAccuracy = PPU_FLOAT_LAZY;
+    bool ppuSpinDetection = true;  // Threads back off in loops polling memory until it is written
+    std::string ppuCachePath = "cache/ppu";  // Directory of the recompiled code cache (disabled if empty)
+    int ppuCompilerThreads = 0;  // Worker threads recompiling each segment (0: One per host core)
+    int ppuTierThreshold = 1000;  // Calls or loop iterations after which the tiered translator recompiles a function
+    int ppuTier2Threshold = 10000;  // Calls to a profiled function after which the tiered translator optimizes it
+    ConfigPpuInstrumentation ppuInstrumentation = PPU_INSTRUMENTATION_NONE;
     ConfigSpuTranslator spuTranslator = SPU_TRANSLATOR_INTERPRETER;
     ConfigGpuBackend gpuBackend = GPU_BACKEND_OPENGL;
 
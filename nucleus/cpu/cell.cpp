@@ -6,6 +6,7 @@
 #include "cell.h"
 #include "nucleus/config.h"
 #include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_dispatch.h"
 #include "nucleus/cpu/ppu/ppu_thread.h"
 #include "nucleus/cpu/ppu/ppu_tables.h"
 
@@ -33,7 +34,9 @@ Cell::Cell()
 
 void Cell::init()
 {
-    if (config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
+    // Recompiled code falls back to the interpreter for indirect branches to code not recompiled
+    ppu_icache.init();
+    if (config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER || config.ppuTranslator == PPU_TRANSLATOR_TIERED) {
         // Global target triple
         llvm::Triple triple(llvm::sys::getProcessTriple());
         if (triple.getOS() == llvm::Triple::OSType::Win32) {
@@ -51,8 +54,6 @@ void Cell::init()
         memoryBase->setLinkage(llvm::GlobalValue::ExternalLinkage);
         memoryBase->setInitializer(llvm::ConstantInt::get(module->getContext(), llvm::APInt(64, (u64)nucleus.memory.getBaseAddr())));
 
-        ppu::State::declareGlobalState(module);
-
         // Build module
         llvm::EngineBuilder engineBuilder(module);
         engineBuilder.setEngineKind(llvm::EngineKind::JIT);
@@ -60,6 +61,51 @@ void Cell::init()
         engineBuilder.setUseMCJIT(true);
         executionEngine = engineBuilder.create();
         executionEngine->finalizeObject();
+
+        // Recompiled code cache
+        ppu_cache.init(config.ppuCachePath);
+    }
+    if (config.ppuTranslator == PPU_TRANSLATOR_TIERED) {
+        ppu_tiering.init(std::max(config.ppuTierThreshold, 1));
+    }
+}
+
+void Cell::addSegment(ppu::Segment* segment)
+{
+    std::lock_guard<std::mutex> lock(ppu_segments_mutex);
+    ppu_segments.push_back(segment);
+}
+
+void Cell::removeSegment(u32 addr)
+{
+    ppu::Segment* segment = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(ppu_segments_mutex);
+        for (auto* item : ppu_segments) {
+            if (item->address == addr) {
+                segment = item;
+            }
+        }
+    }
+    if (!segment) {
+        return;
+    }
+
+    // Recompilations of the segment link imports, so wait for them before taking the lock
+    ppu_tiering.removeSegment(segment);
+
+    // NOTE: The segment is not deleted, since threads might still be returning into its code
+    std::lock_guard<std::mutex> lock(ppu_segments_mutex);
+    ppu_segments.erase(std::remove(ppu_segments.begin(), ppu_segments.end(), segment), ppu_segments.end());
+    ppu_dispatch.clear(segment->address, segment->size);
+}
+
+void Cell::linkImports()
+{
+    // Called by the loader and the tiering thread
+    std::lock_guard<std::mutex> lock(ppu_segments_mutex);
+    for (auto* segment : ppu_segments) {
+        segment->linkImports();
     }
 }
 
@@ -147,6 +193,24 @@ void Cell::stop()
     for (CellThread* thread : ppu_threads) {
         thread->stop();
     }
+
+    // Threads stop between blocks: Release the predecoded pages once none of them is running
+    bool stopped = true;
+    for (CellThread* thread : ppu_threads) {
+        if (thread == getCurrentThread()) {
+            stopped = false;
+            continue;
+        }
+        thread->join();
+    }
+    if (stopped) {
+        ppu_icache.clear();
+    }
+
+    if (config.ppuInstrumentation == PPU_INSTRUMENTATION_PROFILE) {
+        ppu_profiler.dump();
+        nucleus.log.notice(LOG_CPU, "Indirect calls missing the inline caches: %llu", ppu::g_inlineCacheMisses.load());
+    }
 }
 
 }  // namespace cpu
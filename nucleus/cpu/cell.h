@@ -8,7 +8,12 @@
 #include "nucleus/common.h"
 #include "nucleus/cpu/ppu/ppu_thread.h"
 
+#include "nucleus/cpu/ppu/ppu_cache.h"
 #include "nucleus/cpu/ppu/ppu_decoder.h"
+#include "nucleus/cpu/ppu/ppu_dispatch.h"
+#include "nucleus/cpu/ppu/ppu_profiler.h"
+#include "nucleus/cpu/ppu/ppu_tiering.h"
+#include "nucleus/cpu/ppu/interpreter/ppu_interpreter_cache.h"
 
 #include <mutex>
 #include <vector>
@@ -28,16 +33,33 @@ public:
     // Cell threads
     std::vector<ppu::Thread*> ppu_threads;
 
-    // Executable memory segments
+    // Executable memory segments, guarded by the mutex along with the import links of each segment
     std::vector<ppu::Segment*> ppu_segments;
+    std::mutex ppu_segments_mutex;
 
     Cell();
 
     void init();
 
+    // Interpreter utilities
+    ppu::InstructionCache ppu_icache;
+
     // Recompiler utilities
     llvm::Module* module;
     llvm::ExecutionEngine* executionEngine;
+    ppu::ObjectCache ppu_cache;
+    ppu::DispatchTable ppu_dispatch;
+    ppu::Tiering ppu_tiering;
+    ppu::Profiler ppu_profiler;
+
+    // Register a segment, visible to the import linker and the profiler
+    void addSegment(ppu::Segment* segment);
+
+    // Unregister the segment starting at the address, and stop dispatching calls to its recompiled code
+    void removeSegment(u32 addr);
+
+    // Link the calls to import stubs of every segment to the current code of the imported functions
+    void linkImports();
 
     // Thread management
     CellThread* addThread(CellThreadType type, u32 entry);
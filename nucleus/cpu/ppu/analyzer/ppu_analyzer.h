@@ -35,7 +35,9 @@ public:
     AnalyzerEvent fpr[32] = {};
     AnalyzerEvent cr[8] = {};
     AnalyzerEvent fpscr = REG_NONE;
-    AnalyzerEvent xer = REG_NONE;
+    AnalyzerEvent xer = REG_NONE;     // Entire register (mfspr/mtspr)
+    AnalyzerEvent xer_ca = REG_NONE;  // XER[CA] bit
+    AnalyzerEvent xer_ov = REG_NONE;  // XER[OV] and XER[SO] bits
     AnalyzerEvent lr = REG_NONE;
     AnalyzerEvent ctr = REG_NONE;
 
@@ -20,17 +20,33 @@ void Analyzer::bx(Instruction code)
 
 void Analyzer::bcx(Instruction code)
 {
-    // TODO: ?
+    if (!(code.bo & 0x10)) {
+        setFlag(cr[code.bi / 4], REG_READ);
+    }
+    if (!(code.bo & 0x04)) {
+        setFlag(ctr, REG_READ);
+        setFlag(ctr, REG_WRITE);
+    }
 }
 
 void Analyzer::bcctrx(Instruction code)
 {
-    // TODO: ?
+    if (!(code.bo & 0x10)) {
+        setFlag(cr[code.bi / 4], REG_READ);
+    }
+    setFlag(ctr, REG_READ);
 }
 
 void Analyzer::bclrx(Instruction code)
 {
-    // TODO: ?
+    if (!(code.bo & 0x10)) {
+        setFlag(cr[code.bi / 4], REG_READ);
+    }
+    if (!(code.bo & 0x04)) {
+        setFlag(ctr, REG_READ);
+        setFlag(ctr, REG_WRITE);
+    }
+    setFlag(lr, REG_READ);
 }
 
 void Analyzer::crand(Instruction code)
@@ -0,0 +1,192 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_analyzer_flags.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_decoder.h"
+#include "nucleus/cpu/ppu/ppu_tables.h"
+
+#include <map>
+
+namespace cpu {
+namespace ppu {
+
+static void addEvent(FlagEffects& effects, FlagSet flags, AnalyzerEvent evt)
+{
+    if (evt & REG_READ) {
+        effects.read |= flags;
+    }
+    if (evt & REG_WRITE) {
+        effects.write |= flags;
+    }
+}
+
+FlagEffects getFlagEffects(Instruction code)
+{
+    FlagEffects effects;
+    if (!code.is_valid()) {
+        return effects;
+    }
+
+    Analyzer status;
+    auto method = get_entry(code).analyze;
+    (status.*method)(code);
+
+    for (u32 i = 0; i < 8; i++) {
+        addEvent(effects, FLAG_CR0 << i, status.cr[i]);
+    }
+    addEvent(effects, FLAG_XER, status.xer);
+    addEvent(effects, FLAG_XER_CA, status.xer_ca);
+    addEvent(effects, FLAG_XER_OV, status.xer_ov);
+    addEvent(effects, FLAG_FPSCR, status.fpscr);
+
+    // Fields written entirely, unless they are also read
+    effects.kill = effects.write & ~effects.read;
+
+    // Condition register logical instructions only update a single bit of the field
+    if (code.opcode == 0x13 && code.op19 != 0x000) {
+        effects.read |= effects.write & FLAG_CR;
+        effects.kill &= ~FLAG_CR;
+    }
+
+    // Integer results recorded in a CR field copy XER[SO], floating-point ones the FPSCR exception summary
+    if ((effects.write & FLAG_CR) && status.xer == REG_NONE) {
+        switch (code.opcode) {
+        case 0x04: // Vector compares only record the result on CR6
+        case 0x13: // mcrf, CR logical instructions
+            break;
+        case 0x3B:
+        case 0x3F:
+            effects.read |= FLAG_FPSCR;
+            break;
+        case 0x1F:
+            if (code.op31 == 0x090) { // mtocrf
+                break;
+            }
+        default:
+            effects.read |= FLAG_XER_OV;
+            break;
+        }
+    }
+
+    // XER[SO] and the FPSCR exception bits are sticky, so they are never killed by partial updates
+    if (status.xer == REG_NONE) {
+        effects.read |= effects.write & FLAG_XER_OV;
+        effects.kill &= ~FLAG_XER_OV;
+    }
+    effects.read |= effects.write & FLAG_FPSCR;
+    effects.kill &= ~FLAG_FPSCR;
+
+    // Callees might read the flags preserved by the ABI, and clobber any other one
+    if (code.is_call()) {
+        effects.read |= FLAG_NONVOLATILE;
+        effects.kill = FLAG_ALL;
+    }
+    return effects;
+}
+
+std::vector<FlagSet> getLiveFlags(const Block& block)
+{
+    const u32 count = block.size / 4;
+    std::vector<FlagSet> liveFlags(count);
+
+    FlagSet live = block.live_flags_out;
+    for (u32 i = count; i-- > 0;) {
+        liveFlags[i] = live;
+
+        const Instruction code = { nucleus.memory.read32(block.address + 4 * i) };
+        const FlagEffects effects = getFlagEffects(code);
+        live = (live & ~effects.kill) | effects.read;
+    }
+    return liveFlags;
+}
+
+/**
+ * Block summary:
+ * The flags live at the start of a block are (out & ~kill) | read, where out are the flags live at its end.
+ * Composing the effects of its instructions once avoids analyzing them again on every iteration.
+ */
+typedef std::map<u32, FlagEffects> FlagSummaries;
+
+static FlagEffects getBlockEffects(const Block& block)
+{
+    FlagEffects summary;
+    for (u32 addr = block.address + block.size; addr > block.address;) {
+        addr -= 4;
+        const Instruction code = { nucleus.memory.read32(addr) };
+        const FlagEffects effects = getFlagEffects(code);
+        summary.read = (summary.read & ~effects.kill) | effects.read;
+        summary.write |= effects.write;
+        summary.kill |= effects.kill;
+    }
+    return summary;
+}
+
+// Get the flags live at the start of a block, or all of them if the address leaves the function
+static FlagSet getLiveFlagsIn(const Function& function, const FlagSummaries& summaries, u32 addr)
+{
+    auto it = function.blocks.find(addr);
+    if (it == function.blocks.end()) {
+        return FLAG_ALL;
+    }
+    const FlagEffects& summary = summaries.at(addr);
+    return (it->second.live_flags_out & ~summary.kill) | summary.read;
+}
+
+// Get the flags live at the end of a block, from the flags live at the start of its successors
+static FlagSet getLiveFlagsOut(const Function& function, const FlagSummaries& summaries, const Block& block)
+{
+    if (block.is_split()) {
+        return getLiveFlagsIn(function, summaries, block.address + block.size);
+    }
+    const Instruction last = { nucleus.memory.read32(block.address + block.size - 4) };
+    if (last.is_return()) {
+        // Conditional returns fall through to code outside of the CFG
+        return ((last.bo & 0x14) == 0x14) ? FLAG_NONVOLATILE : FLAG_ALL;
+    }
+
+    // Indirect jumps might go anywhere, unless their jump table was recovered
+    if (!block.branch_a && !block.branch_b && block.branch_table.empty()) {
+        return FLAG_ALL;
+    }
+    FlagSet live = FLAG_NONE;
+    for (u32 target : block.branch_table) {
+        live |= getLiveFlagsIn(function, summaries, target);
+    }
+    if (block.branch_a) {
+        live |= getLiveFlagsIn(function, summaries, block.branch_a);
+    }
+    if (block.branch_b) {
+        live |= getLiveFlagsIn(function, summaries, block.branch_b);
+    }
+    return live;
+}
+
+void analyzeFlagLiveness(Function& function)
+{
+    FlagSummaries summaries;
+    for (auto& item : function.blocks) {
+        item.second.live_flags_out = FLAG_NONE;
+        summaries[item.first] = getBlockEffects(item.second);
+    }
+
+    // Live sets only grow, so this reaches a fixed point after a few iterations
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        // Visiting the blocks backwards propagates the liveness of most loops in a single iteration
+        for (auto it = function.blocks.rbegin(); it != function.blocks.rend(); it++) {
+            Block& block = it->second;
+            const FlagSet live = block.live_flags_out | getLiveFlagsOut(function, summaries, block);
+            if (live != block.live_flags_out) {
+                block.live_flags_out = live;
+                changed = true;
+            }
+        }
+    }
+}
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,66 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/ppu/ppu_instruction.h"
+
+#include <vector>
+
+namespace cpu {
+namespace ppu {
+
+// Class declarations
+class Block;
+class Function;
+
+/**
+ * Flag liveness:
+ * Condition and status registers updated as a side effect of many instructions. An update is dead
+ * if every path overwrites the flag before reading it, in which case the recompiler skips it.
+ */
+enum AnalyzerFlag : u16 {
+    FLAG_NONE   = 0,
+    FLAG_CR0    = (1 << 0),  // CR fields (FLAG_CR0 << n for the field n)
+    FLAG_CR1    = (1 << 1),
+    FLAG_CR2    = (1 << 2),
+    FLAG_CR3    = (1 << 3),
+    FLAG_CR4    = (1 << 4),
+    FLAG_CR5    = (1 << 5),
+    FLAG_CR6    = (1 << 6),
+    FLAG_CR7    = (1 << 7),
+    FLAG_XER_CA = (1 << 8),  // XER[CA]
+    FLAG_XER_OV = (1 << 9),  // XER[OV] and XER[SO]
+    FLAG_FPSCR  = (1 << 10),
+
+    FLAG_CR  = 0x00FF,
+    FLAG_XER = FLAG_XER_CA | FLAG_XER_OV,
+    FLAG_ALL = 0x07FF,
+
+    // Flags preserved across calls by the PPU ABI, and thus live when a function returns
+    FLAG_NONVOLATILE = FLAG_CR2 | FLAG_CR3 | FLAG_CR4 | FLAG_FPSCR,
+};
+
+typedef u16 FlagSet;
+
+struct FlagEffects
+{
+    FlagSet read = FLAG_NONE;   // Flags whose value is used
+    FlagSet write = FLAG_NONE;  // Flags updated
+    FlagSet kill = FLAG_NONE;   // Flags updated without depending on their previous value
+};
+
+// Get the flags accessed by an instruction
+FlagEffects getFlagEffects(Instruction code);
+
+// Get the flags live after each instruction of a block, from the flags live at its end
+std::vector<FlagSet> getLiveFlags(const Block& block);
+
+// Determine the flags live at the end of each block of a function (iterated until reaching a fixed point)
+void analyzeFlagLiveness(Function& function);
+
+}  // namespace ppu
+}  // namespace cpu
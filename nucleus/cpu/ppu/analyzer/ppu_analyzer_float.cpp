@@ -398,10 +398,10 @@ void Analyzer::fsubsx(Instruction code)
 
 void Analyzer::mcrfs(Instruction code)
 {
-    // TODO: Set only the potential modifiable CR fields based on the mask
-    for (int i = 0; i < 8; i++) {
-        setFlag(cr[i], REG_WRITE);
-    }
+    // Exception bits of the copied FPSCR field are cleared
+    setFlag(fpscr, REG_READ);
+    setFlag(fpscr, REG_WRITE);
+    setFlag(cr[code.crfd], REG_WRITE);
 }
 
 void Analyzer::mffsx(Instruction code)
@@ -0,0 +1,42 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_analyzer_imports.h"
+#include "nucleus/cpu/ppu/ppu_decoder.h"
+
+namespace cpu {
+namespace ppu {
+
+bool findImportStub(const Segment& segment, u32 addr, u32& slot)
+{
+    // Instructions of the stub, with the fields holding the import table address masked out
+    static const u32 pattern[IMPORT_STUB_INSTRUCTIONS][2] = {
+        { 0x39800000, 0xFFFFFFFF },  // li     r12, 0
+        { 0x658C0000, 0xFFFF0000 },  // oris   r12, r12, slot@hi
+        { 0x818C0000, 0xFFFF0000 },  // lwz    r12, slot@l(r12)
+        { 0xF8410028, 0xFFFFFFFF },  // std    r2, 40(r1)
+        { 0x800C0000, 0xFFFFFFFF },  // lwz    r0, 0(r12)
+        { 0x804C0004, 0xFFFFFFFF },  // lwz    r2, 4(r12)
+        { 0x7C0903A6, 0xFFFFFFFF },  // mtctr  r0
+        { 0x4E800420, 0xFFFFFFFF },  // bctr
+    };
+    if (!segment.contains(addr) || !segment.contains(addr + 4 * (IMPORT_STUB_INSTRUCTIONS - 1))) {
+        return false;
+    }
+    for (u32 i = 0; i < IMPORT_STUB_INSTRUCTIONS; i++) {
+        const Instruction code = segment.getInstruction(addr + 4 * i);
+        if ((code.instruction & pattern[i][1]) != pattern[i][0]) {
+            return false;
+        }
+    }
+
+    const Instruction oris = segment.getInstruction(addr + 4);
+    const Instruction lwz = segment.getInstruction(addr + 8);
+    slot = (oris.uimm << 16) + lwz.d;
+    return true;
+}
+
+}  // namespace ppu
+}  // namespace cpu
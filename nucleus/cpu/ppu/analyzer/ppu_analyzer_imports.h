@@ -0,0 +1,39 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+namespace cpu {
+namespace ppu {
+
+// Class declarations
+class Segment;
+
+/**
+ * Import stubs:
+ * Calls to functions exported by other modules go through a stub generated by the linker, which reads
+ * the address of the function descriptor (OPD) from the import table, saves the TOC base of the caller
+ * and branches to the imported function with its own TOC base:
+ *
+ *   li      r12, 0
+ *   oris    r12, r12, slot@hi
+ *   lwz     r12, slot@l(r12)         # Descriptor address, written when the exporting module is started
+ *   std     r2, 40(r1)               # Save the TOC base of the caller, restored after the call returns
+ *   lwz     r0, 0(r12)               # Function address
+ *   lwz     r2, 4(r12)               # TOC base of the imported function
+ *   mtctr   r0
+ *   bctr
+ */
+
+// Number of instructions of an import stub
+static const u32 IMPORT_STUB_INSTRUCTIONS = 8;
+
+// Determine whether the function at the address is an import stub, returning the address of its import table entry
+bool findImportStub(const Segment& segment, u32 addr, u32& slot);
+
+}  // namespace ppu
+}  // namespace cpu
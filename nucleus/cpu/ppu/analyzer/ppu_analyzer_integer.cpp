@@ -23,7 +23,7 @@ void Analyzer::addx(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -32,13 +32,13 @@ void Analyzer::addcx(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -47,14 +47,14 @@ void Analyzer::addex(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_READ); // XER CA
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_READ);
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -70,14 +70,14 @@ void Analyzer::addic(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
 }
 
 void Analyzer::addic_(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
     setFlag(cr[0], REG_WRITE);
 }
 
@@ -93,14 +93,14 @@ void Analyzer::addmex(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_READ); // XER CA
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_READ);
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -108,14 +108,14 @@ void Analyzer::addzex(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_READ); // XER CA
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_READ);
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -191,7 +191,7 @@ void Analyzer::divdx(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -225,7 +225,7 @@ void Analyzer::divdux(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -239,7 +239,7 @@ void Analyzer::divwx(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -253,7 +253,7 @@ void Analyzer::divwux(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -352,7 +352,7 @@ void Analyzer::mulldx(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -372,7 +372,7 @@ void Analyzer::mullwx(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -396,7 +396,7 @@ void Analyzer::negx(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -556,7 +556,7 @@ void Analyzer::sradx(Instruction code)
     setFlag(gpr[code.rs], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.ra], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
@@ -567,7 +567,7 @@ void Analyzer::sradix(Instruction code)
 {
     setFlag(gpr[code.rs], REG_READ);
     setFlag(gpr[code.ra], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
@@ -579,7 +579,7 @@ void Analyzer::srawx(Instruction code)
     setFlag(gpr[code.rs], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.ra], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
@@ -590,7 +590,7 @@ void Analyzer::srawix(Instruction code)
 {
     setFlag(gpr[code.rs], REG_READ);
     setFlag(gpr[code.ra], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
@@ -629,7 +629,7 @@ void Analyzer::subfx(Instruction code)
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -638,13 +638,13 @@ void Analyzer::subfcx(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -653,14 +653,14 @@ void Analyzer::subfex(Instruction code)
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rb], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_READ); // XER CA
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_READ);
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -668,21 +668,21 @@ void Analyzer::subfic(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_WRITE);
 }
 
 void Analyzer::subfmex(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_READ); // XER CA
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_READ);
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
@@ -690,14 +690,14 @@ void Analyzer::subfzex(Instruction code)
 {
     setFlag(gpr[code.ra], REG_READ);
     setFlag(gpr[code.rd], REG_WRITE);
-    setFlag(xer, REG_READ); // XER CA
-    setFlag(xer, REG_WRITE); // XER CA
+    setFlag(xer_ca, REG_READ);
+    setFlag(xer_ca, REG_WRITE);
 
     if (code.rc) {
         setFlag(cr[0], REG_WRITE);
     }
     if (code.oe) {
-        setFlag(xer, REG_WRITE); // XER OV
+        setFlag(xer_ov, REG_WRITE);
     }
 }
 
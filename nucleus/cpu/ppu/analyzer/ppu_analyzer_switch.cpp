@@ -0,0 +1,226 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_analyzer_switch.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_decoder.h"
+#include "nucleus/cpu/ppu/ppu_tables.h"
+
+#include <set>
+
+namespace cpu {
+namespace ppu {
+
+// Maximum number of instructions followed when computing the value of a register
+static const u32 MAX_RESOLVE_DEPTH = 4;
+
+// Find the closest instruction before the address matching the predicate, only crossing conditional branches
+template <typename T>
+static u32 findBackwards(const Segment& segment, u32 addr, u32 limit, T predicate)
+{
+    while (addr > limit) {
+        addr -= 4;
+        const Instruction code = segment.getInstruction(addr);
+        if (!code.is_valid() || code.is_call() || (code.is_branch() && !code.is_branch_conditional())) {
+            return 0;
+        }
+
+        Analyzer status;
+        auto method = get_entry(code).analyze;
+        (status.*method)(code);
+        if (predicate(code, status)) {
+            return addr;
+        }
+    }
+    return 0;
+}
+
+// Find the closest instruction before the address writing the GPR
+static u32 findWriter(const Segment& segment, u32 addr, u32 limit, u32 reg)
+{
+    return findBackwards(segment, addr, limit, [=](Instruction code, const Analyzer& status) {
+        return (status.gpr[reg] & REG_WRITE) != 0;
+    });
+}
+
+static bool isReadable(u32 addr, u32 size)
+{
+    return nucleus.memory(SEG_MAIN_MEMORY).isValid(addr) && nucleus.memory(SEG_MAIN_MEMORY).isValid(addr + size - 1);
+}
+
+// Compute the constant value of the GPR right before the address, if it only depends on immediates, the TOC and constant data
+static bool resolveValue(const Segment& segment, u32 addr, u32 limit, u32 reg, u32& value, u32 depth=MAX_RESOLVE_DEPTH)
+{
+    // The TOC base is set before entering the function, and only reloaded after calls to other modules
+    if (reg == 2 && segment.toc) {
+        value = segment.toc;
+        return true;
+    }
+    const u32 writer = findWriter(segment, addr, limit, reg);
+    if (!writer || depth == 0) {
+        return false;
+    }
+
+    const Instruction code = segment.getInstruction(writer);
+    u32 base = 0;
+    switch (code.opcode) {
+    case 0x0E: // addi
+    case 0x0F: // addis
+        if (code.ra && !resolveValue(segment, writer, limit, code.ra, base, depth - 1)) {
+            return false;
+        }
+        value = base + ((code.opcode == 0x0E) ? (u32)code.simm : ((u32)code.simm << 16));
+        return true;
+
+    case 0x18: // ori
+        if (!resolveValue(segment, writer, limit, code.rs, base, depth - 1)) {
+            return false;
+        }
+        value = base | code.uimm;
+        return true;
+
+    case 0x20: // lwz
+    case 0x3A: // ld
+        if ((code.opcode == 0x3A && code.op58 != 0) || code.ra == reg) {
+            return false;
+        }
+        if (code.ra && !resolveValue(segment, writer, limit, code.ra, base, depth - 1)) {
+            return false;
+        }
+        if (code.opcode == 0x20) {
+            base += code.d;
+            if (!isReadable(base, 4)) {
+                return false;
+            }
+            value = nucleus.memory.read32(base);
+        } else {
+            base += (code.ds << 2);
+            if (!isReadable(base, 8)) {
+                return false;
+            }
+            value = (u32)nucleus.memory.read64(base);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool findJumpTable(const Segment& segment, u32 addr, std::vector<u32>& targets)
+{
+    const Instruction bctr = segment.getInstruction(addr);
+    if (bctr.opcode != 0x13 || bctr.op19 != 0x210 || bctr.lk || (bctr.bo & 0x14) != 0x14) {
+        return false;
+    }
+    const u32 window = 4 * JUMP_TABLE_MAX_INSTRUCTIONS;
+    const u32 limit = (addr - segment.address > window) ? (addr - window) : segment.address;
+
+    // Branch target: mtctr rE
+    const u32 mtctr = findBackwards(segment, addr, limit, [](Instruction code, const Analyzer& status) {
+        return (status.ctr & REG_WRITE) != 0;
+    });
+    if (!mtctr) {
+        return false;
+    }
+    Instruction code = segment.getInstruction(mtctr);
+    if (code.opcode != 0x1F || code.op31 != 0x1D3) {
+        return false;
+    }
+
+    // Entries relative to a base address: add rE, rE, rT
+    u32 load = findWriter(segment, mtctr, limit, code.rs);
+    if (!load) {
+        return false;
+    }
+    code = segment.getInstruction(load);
+    bool relative = false;
+    u32 relativeBase = 0;
+    if (code.opcode == 0x1F && code.op31 == 0x10A && !code.oe && !code.rc) {
+        const u32 operands[2] = { code.ra, code.rb };
+        for (u32 i = 0; i < 2 && !relative; i++) {
+            if (resolveValue(segment, load, limit, operands[i], relativeBase)) {
+                relative = true;
+                load = findWriter(segment, load, limit, operands[1 - i]);
+            }
+        }
+        if (!relative || !load) {
+            return false;
+        }
+        code = segment.getInstruction(load);
+    }
+
+    // Table entry: lwzx/lwax rE, rT, rI
+    if (code.opcode != 0x1F || (code.op31 != 0x017 && code.op31 != 0x155) || !code.ra) {
+        return false;
+    }
+    u32 table = 0;
+    u32 indexReg = 0;
+    if (resolveValue(segment, load, limit, code.ra, table)) {
+        indexReg = code.rb;
+    } else if (resolveValue(segment, load, limit, code.rb, table)) {
+        indexReg = code.ra;
+    } else {
+        return false;
+    }
+
+    // Scaling: rlwinm rI, rX, 2, 0, 29
+    const u32 scale = findWriter(segment, load, limit, indexReg);
+    if (!scale) {
+        return false;
+    }
+    code = segment.getInstruction(scale);
+    if (code.opcode != 0x15 || code.sh != 2 || code.mb != 0 || code.me != 29 || code.rc) {
+        return false;
+    }
+    const u32 index = code.rs;
+
+    // Bound check: cmplwi crN, rX, bound, as long as the index is not modified afterwards
+    const u32 compare = findBackwards(segment, scale, limit, [=](Instruction code, const Analyzer& status) {
+        return (status.gpr[index] & REG_WRITE) || (code.opcode == 0x0A && !code.l10 && code.ra == index);
+    });
+    if (!compare) {
+        return false;
+    }
+    code = segment.getInstruction(compare);
+    if (code.opcode != 0x0A) {
+        return false;
+    }
+    const u32 field = code.crfd;
+    const u32 bound = code.uimm;
+
+    // Branch to the default case: bgt crN (index > count-1) or bge crN (index >= count)
+    u32 count = 0;
+    for (u32 i = compare + 4; i < addr && !count; i += 4) {
+        const Instruction bc = segment.getInstruction(i);
+        if (bc.opcode != 0x10 || bc.lk || bc.bi / 4 != field) {
+            continue;
+        }
+        if ((bc.bo & 0x1C) == 0x0C && bc.bi % 4 == 1) {
+            count = bound + 1;
+        } else if ((bc.bo & 0x1C) == 0x04 && bc.bi % 4 == 0) {
+            count = bound;
+        } else {
+            return false;
+        }
+    }
+    if (count == 0 || count > JUMP_TABLE_MAX_ENTRIES || !isReadable(table, 4 * count)) {
+        return false;
+    }
+
+    // Targets must be valid instructions of the segment, duplicates (e.g. default cases) are only listed once
+    std::set<u32> unique;
+    for (u32 i = 0; i < count; i++) {
+        const u32 entry = nucleus.memory.read32(table + 4 * i);
+        const u32 target = relative ? (relativeBase + entry) : entry;
+        if ((target & 0x3) || !segment.contains(target) || !segment.getInstruction(target).is_valid()) {
+            return false;
+        }
+        unique.insert(target);
+    }
+    targets.assign(unique.begin(), unique.end());
+    return true;
+}
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,43 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include <vector>
+
+namespace cpu {
+namespace ppu {
+
+// Class declarations
+class Segment;
+
+/**
+ * Jump tables:
+ * Compiled switch statements check the bounds of the index, scale it and load the target from a table,
+ * usually addressed through the TOC, before branching to it:
+ *
+ *   cmplwi  crN, rX, count-1         # Bound check, or cmplwi crN, rX, count
+ *   bgt     crN, default             #              followed by bge crN, default
+ *   ld      rT, table@toc(r2)        # Table address: ld/lwz from the TOC, or addis/addi/ori
+ *   rlwinm  rI, rX, 2, 0, 29         # Scaling: slwi rI, rX, 2
+ *   lwzx    rE, rT, rI               # Entry: lwzx/lwax
+ *   add     rE, rE, rT               # Optional: Entries relative to the table
+ *   mtctr   rE
+ *   bctr
+ */
+
+// Maximum number of instructions scanned backwards from the bctr looking for the pattern
+static const u32 JUMP_TABLE_MAX_INSTRUCTIONS = 32;
+
+// Maximum number of entries of a recovered table
+static const u32 JUMP_TABLE_MAX_ENTRIES = 1024;
+
+// Recover the targets of the jump table branched to by the bctr at the address, returning false if not recognized
+bool findJumpTable(const Segment& segment, u32 addr, std::vector<u32>& targets);
+
+}  // namespace ppu
+}  // namespace cpu
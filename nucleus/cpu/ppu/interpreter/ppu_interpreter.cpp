@@ -6,6 +6,7 @@
 #include "ppu_interpreter.h"
 #include "nucleus/emulator.h"
 #include "nucleus/cpu/ppu/ppu_tables.h"
+#include "nucleus/cpu/ppu/interpreter/ppu_interpreter_cache.h"
 
 #include <algorithm>
 #include <cmath>
@@ -31,18 +32,85 @@ void Interpreter::initRotateMask()
     initialized = true;
 }
 
-Interpreter::Interpreter(u32 entry, u32 stack)
+Interpreter::Interpreter(u32 entry, u32 stack) : m_fusedHits()
 {
     Interpreter::initRotateMask();
+    nucleus.cell.ppu_icache.addReader(&m_cacheEpoch);
+}
+
+Interpreter::~Interpreter()
+{
+    nucleus.cell.ppu_icache.removeReader(&m_cacheEpoch);
+
+    static const char* fusedNames[FUSED_COUNT] = {
+        "lis+ori", "lis+addi", "rlwinm+cmpwi", "mflr+stw+stwu", "mflr+std+stdu", "lwz+mtctr+bctr",
+    };
+    for (u32 i = 0; i < FUSED_COUNT; i++) {
+        if (m_fusedHits[i]) {
+            nucleus.log.notice(LOG_CPU, "Superinstruction %s: %llu hits", fusedNames[i], m_fusedHits[i]);
+        }
+    }
+}
+
+void Interpreter::enterCache()
+{
+    if (m_cacheDepth++ == 0) {
+        nucleus.cell.ppu_icache.enter(m_cacheEpoch);
+    }
+}
+
+void Interpreter::leaveCache()
+{
+    if (--m_cacheDepth == 0) {
+        nucleus.cell.ppu_icache.leave(m_cacheEpoch);
+    }
 }
 
 void Interpreter::step()
 {
-    const Instruction code = { nucleus.memory.read32(state.pc) };
-    auto method = get_entry(code).interpret;
-    (this->*method)(code);
+    enterCache();
+    m_entry = &nucleus.cell.ppu_icache.get(state.pc);
+    (this->*m_entry->handler)(m_entry->code);
 
-    state.pc += 4;
+    if (!(m_entry->flags & CACHED_BLOCK_END)) {
+        state.pc += 4 * m_entry->size;
+    }
+    leaveCache();
+}
+
+u32 Interpreter::runBlock()
+{
+    enterCache();
+    const u32 branch = runCachedBlock();
+    leaveCache();
+    return branch;
+}
+
+u32 Interpreter::runCachedBlock()
+{
+    // Blocks crossing a page boundary are split, since the next page might not be cached yet
+    InstructionCache::Page* page = nucleus.cell.ppu_icache.getPage(state.pc);
+    const CachedInstruction* end = &page->entries[InstructionCache::PAGE_ENTRIES];
+
+    m_entry = &page->entries[(state.pc & (InstructionCache::PAGE_SIZE - 1)) >> 2];
+    while (m_entry != end) {
+        const u32 pc = state.pc;
+        (this->*m_entry->handler)(m_entry->code);
+        if (m_entry->flags & CACHED_BLOCK_END) {
+            return pc + 4 * (m_entry->size - 1);
+        }
+        state.pc += 4 * m_entry->size;
+        m_entry += m_entry->size;
+    }
+    return 0;
+}
+
+Interpreter::Handler Interpreter::specialize(Handler handler, Instruction code)
+{
+    handler = specializeInteger(handler, code);
+    handler = specializeMemory(handler, code);
+    handler = specializeBranch(handler, code);
+    return handler;
 }
 
 // Unknown instruction
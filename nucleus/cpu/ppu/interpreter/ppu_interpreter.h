@@ -10,23 +10,60 @@
 #include "nucleus/cpu/ppu/ppu_thread.h"
 #include "nucleus/cpu/ppu/ppu_instruction.h"
 
+#include <atomic>
+
 namespace cpu {
 namespace ppu {
 
+struct CachedInstruction;
+
+// Superinstructions
+enum FusedPattern {
+    FUSED_LIS_ORI = 0,     // lis rX,hi + ori rY,rX,lo
+    FUSED_LIS_ADDI,        // lis rX,hi + addi rY,rX,lo
+    FUSED_RLWINM_CMPWI,    // rlwinm[.] rA,rS,sh,mb,me + cmpwi crfD,rA,simm
+    FUSED_MFLR_STW_STWU,   // mflr rX + stw rX,d(rA) + stwu rS,d(rB)
+    FUSED_MFLR_STD_STDU,   // mflr rX + std rX,ds(rA) + stdu rS,ds(rB)
+    FUSED_LWZ_MTCTR_BCTR,  // lwz rX,d(rA) + [lwz rY,d(rA)] + mtctr rX + bctr
+
+    // Count of superinstructions
+    FUSED_COUNT,
+};
+
 class Interpreter
 {
     // Rotation mask
     static u64 rotateMask[64][64];
     static void initRotateMask();
 
+    // Predecoded instruction being executed
+    const CachedInstruction* m_entry = nullptr;
+
+    // Epoch announced to the instruction cache while its pages are held. Handlers might run
+    // nested blocks (e.g. callbacks), which keep the epoch of the outermost one.
+    std::atomic<u64> m_cacheEpoch;
+    u32 m_cacheDepth = 0;
+
+    void enterCache();
+    void leaveCache();
+    u32 runCachedBlock();
+
+    // Number of times each superinstruction was executed
+    u64 m_fusedHits[FUSED_COUNT];
+
 public:
     State state;
 
     Interpreter(u32 entry, u32 stack);
+    ~Interpreter();
 
     // Decode and execute one instruction
     void step();
 
+    // Execute instructions until the end of the current basic block, returning the address
+    // of the instruction ending it, or 0 if the block continues in the next page
+    u32 runBlock();
+
     /**
      * Auxiliary functions
      */
@@ -460,6 +497,165 @@ public:
     void vupklsh(Instruction code);
     void vxor(Instruction code);
 
+    /**
+     * Host-specific handlers:
+     * Replace the portable implementation of some instructions if the host CPU supports them.
+     */
+    using Handler = void (Interpreter::*)(Instruction);
+    static Handler selectHandler(Handler handler);
+
+    // Vector/SIMD Instructions: SSE4.1
+    void vaddfp_sse41(Instruction code);
+    void vaddsbs_sse41(Instruction code);
+    void vaddshs_sse41(Instruction code);
+    void vaddsws_sse41(Instruction code);
+    void vaddubm_sse41(Instruction code);
+    void vaddubs_sse41(Instruction code);
+    void vadduhm_sse41(Instruction code);
+    void vadduhs_sse41(Instruction code);
+    void vadduwm_sse41(Instruction code);
+    void vadduws_sse41(Instruction code);
+    void vand_sse41(Instruction code);
+    void vandc_sse41(Instruction code);
+    void vavgub_sse41(Instruction code);
+    void vcmpeqfp_sse41(Instruction code);
+    void vcmpequb_sse41(Instruction code);
+    void vcmpequh_sse41(Instruction code);
+    void vcmpequw_sse41(Instruction code);
+    void vcmpgefp_sse41(Instruction code);
+    void vcmpgtfp_sse41(Instruction code);
+    void vcmpgtsw_sse41(Instruction code);
+    void vcmpgtuw_sse41(Instruction code);
+    void vmaddfp_sse41(Instruction code);
+    void vmaxfp_sse41(Instruction code);
+    void vmaxsw_sse41(Instruction code);
+    void vmaxub_sse41(Instruction code);
+    void vminfp_sse41(Instruction code);
+    void vminsw_sse41(Instruction code);
+    void vminub_sse41(Instruction code);
+    void vmrghw_sse41(Instruction code);
+    void vmrglw_sse41(Instruction code);
+    void vnmsubfp_sse41(Instruction code);
+    void vnor_sse41(Instruction code);
+    void vor_sse41(Instruction code);
+    void vperm_sse41(Instruction code);
+    void vsel_sse41(Instruction code);
+    void vsldoi_sse41(Instruction code);
+    void vspltw_sse41(Instruction code);
+    void vsubfp_sse41(Instruction code);
+    void vsubsbs_sse41(Instruction code);
+    void vsubshs_sse41(Instruction code);
+    void vsubsws_sse41(Instruction code);
+    void vsububm_sse41(Instruction code);
+    void vsububs_sse41(Instruction code);
+    void vsubuhm_sse41(Instruction code);
+    void vsubuhs_sse41(Instruction code);
+    void vsubuwm_sse41(Instruction code);
+    void vsubuws_sse41(Instruction code);
+    void vsum4ubs_sse41(Instruction code);
+    void vxor_sse41(Instruction code);
+
+    /**
+     * Specialized handlers:
+     * Variants of frequent instructions where fields that never change for a given instruction
+     * word (RA being r0, RC, L, LK, AA) are resolved at compile time. The instruction cache picks
+     * the variant once when decoding, while the generic handlers dispatch to them at runtime.
+     */
+    static Handler specialize(Handler handler, Instruction code);
+    static Handler specializeBranch(Handler handler, Instruction code);
+    static Handler specializeInteger(Handler handler, Instruction code);
+    static Handler specializeMemory(Handler handler, Instruction code);
+
+    // UISA: Integer instructions (Section: 4.2.1)
+    template <bool RA> void addi_t(Instruction code);
+    template <bool RA> void addis_t(Instruction code);
+    template <bool RC> void addx_t(Instruction code);
+    template <bool RC> void andcx_t(Instruction code);
+    template <bool RC> void andx_t(Instruction code);
+    template <bool L> void cmp_t(Instruction code);
+    template <bool L> void cmpi_t(Instruction code);
+    template <bool L> void cmpl_t(Instruction code);
+    template <bool L> void cmpli_t(Instruction code);
+    template <bool RC> void cntlzwx_t(Instruction code);
+    template <bool RC> void extsbx_t(Instruction code);
+    template <bool RC> void extshx_t(Instruction code);
+    template <bool RC> void extswx_t(Instruction code);
+    template <bool RC> void mullwx_t(Instruction code);
+    template <bool RC> void negx_t(Instruction code);
+    template <bool RC> void norx_t(Instruction code);
+    template <bool RC> void orx_t(Instruction code);
+    template <bool RC> void rldiclx_t(Instruction code);
+    template <bool RC> void rldicrx_t(Instruction code);
+    template <bool RC> void rlwimix_t(Instruction code);
+    template <bool RC> void rlwinmx_t(Instruction code);
+    template <bool RC> void sldx_t(Instruction code);
+    template <bool RC> void slwx_t(Instruction code);
+    template <bool RC> void sradix_t(Instruction code);
+    template <bool RC> void srawix_t(Instruction code);
+    template <bool RC> void srdx_t(Instruction code);
+    template <bool RC> void srwx_t(Instruction code);
+    template <bool RC> void subfx_t(Instruction code);
+    template <bool RC> void xorx_t(Instruction code);
+
+    // UISA: Load and Store Instructions (Section: 4.2.3)
+    template <bool RA> void lbz_t(Instruction code);
+    template <bool RA> void lbzx_t(Instruction code);
+    template <bool RA> void ld_t(Instruction code);
+    template <bool RA> void ldx_t(Instruction code);
+    template <bool RA> void lfd_t(Instruction code);
+    template <bool RA> void lfdx_t(Instruction code);
+    template <bool RA> void lfs_t(Instruction code);
+    template <bool RA> void lfsx_t(Instruction code);
+    template <bool RA> void lha_t(Instruction code);
+    template <bool RA> void lhax_t(Instruction code);
+    template <bool RA> void lhz_t(Instruction code);
+    template <bool RA> void lhzx_t(Instruction code);
+    template <bool RA> void lwa_t(Instruction code);
+    template <bool RA> void lwax_t(Instruction code);
+    template <bool RA> void lwz_t(Instruction code);
+    template <bool RA> void lwzx_t(Instruction code);
+    template <bool RA> void stb_t(Instruction code);
+    template <bool RA> void stbx_t(Instruction code);
+    template <bool RA> void std_t(Instruction code);
+    template <bool RA> void stdx_t(Instruction code);
+    template <bool RA> void stfd_t(Instruction code);
+    template <bool RA> void stfdx_t(Instruction code);
+    template <bool RA> void stfs_t(Instruction code);
+    template <bool RA> void stfsx_t(Instruction code);
+    template <bool RA> void sth_t(Instruction code);
+    template <bool RA> void sthx_t(Instruction code);
+    template <bool RA> void stw_t(Instruction code);
+    template <bool RA> void stwx_t(Instruction code);
+
+    // UISA: Branch and Flow Control Instructions (Section: 4.2.4)
+    template <bool LK, bool AA> void bx_t(Instruction code);
+    template <bool LK, bool AA> void bcx_t(Instruction code);
+    template <bool LK> void bcctrx_t(Instruction code);
+    template <bool LK> void bclrx_t(Instruction code);
+
+    /**
+     * Superinstructions:
+     * Sequences of instructions frequently emitted by the PS3 toolchain, executed as one.
+     * The remaining instructions of the sequence are read from the next cache entries.
+     */
+    static bool fuse(CachedInstruction* entry, u32 count);
+
+    void fused_lis_ori(Instruction code);
+    void fused_lis_addi(Instruction code);
+    void fused_rlwinm_cmpwi(Instruction code);
+    void fused_mflr_stw_stwu(Instruction code);
+    void fused_mflr_std_stdu(Instruction code);
+    void fused_lwz_mtctr_bctr(Instruction code);
+
+    /**
+     * Spin loops:
+     * Conditional branches closing a spin loop back off when they are taken
+     * without the polled memory having changed.
+     */
+    static bool detectSpin(CachedInstruction* entry, u32 addr);
+
+    void spin_bcx(Instruction code);
+
     // Unknown instruction
     void unknown(Instruction code);
     static void unknown(const char* instruction);
@@ -4,7 +4,9 @@
  */
 
 #include "ppu_interpreter.h"
+#include "ppu_interpreter_cache.h"
 #include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_spin.h"
 
 namespace cpu {
 namespace ppu {
@@ -27,43 +29,83 @@ bool CheckCondition(State& state, u32 bo, u32 bi)
 /**
  * PPC64 Instructions:
  *  - UISA: Branch and Flow Control Instructions (Section: 4.2.4)
+ * Branches and system calls end basic blocks and are responsible for updating the PC.
  */
 
+template <bool LK, bool AA>
+void Interpreter::bx_t(Instruction code)
+{
+    if (LK) state.lr = state.pc + 4;
+    state.pc = (AA ? (code.li << 2) : state.pc + (code.li << 2)) & ~0x3ULL;
+}
+
 void Interpreter::bx(Instruction code)
 {
-    if (code.lk) state.lr = state.pc + 4;
-    state.pc = (code.aa ? (code.li << 2) : state.pc + (code.li << 2)) & ~0x3ULL;
-    state.pc -= 4;
+    if (code.lk) {
+        code.aa ? bx_t<true, true>(code) : bx_t<true, false>(code);
+    }
+    else {
+        code.aa ? bx_t<false, true>(code) : bx_t<false, false>(code);
+    }
 }
 
-void Interpreter::bcx(Instruction code)
+template <bool LK, bool AA>
+void Interpreter::bcx_t(Instruction code)
 {
     if (CheckCondition(state, code.bo, code.bi)) {
-        if (code.lk) state.lr = state.pc + 4;
-        state.pc = (code.aa ? (code.bd << 2) : state.pc + (code.bd << 2)) & ~0x3ULL;
-        state.pc -= 4;
+        if (LK) state.lr = state.pc + 4;
+        state.pc = (AA ? (code.bd << 2) : state.pc + (code.bd << 2)) & ~0x3ULL;
+    }
+    else {
+        state.pc += 4;
     }
 }
 
-void Interpreter::bcctrx(Instruction code)
+void Interpreter::bcx(Instruction code)
+{
+    if (code.lk) {
+        code.aa ? bcx_t<true, true>(code) : bcx_t<true, false>(code);
+    }
+    else {
+        code.aa ? bcx_t<false, true>(code) : bcx_t<false, false>(code);
+    }
+}
+
+template <bool LK>
+void Interpreter::bcctrx_t(Instruction code)
 {
     if (code.bo & 0x10 || state.cr.getBit(code.bi) == ((code.bo >> 3) & 1)) {
-        if (code.lk) state.lr = state.pc + 4;
+        if (LK) state.lr = state.pc + 4;
         state.pc = state.ctr & ~0x3ULL;
-        state.pc -= 4;
+    }
+    else {
+        state.pc += 4;
     }
 }
 
-void Interpreter::bclrx(Instruction code)
+void Interpreter::bcctrx(Instruction code)
+{
+    code.lk ? bcctrx_t<true>(code) : bcctrx_t<false>(code);
+}
+
+template <bool LK>
+void Interpreter::bclrx_t(Instruction code)
 {
     if (CheckCondition(state, code.bo, code.bi)) {
         const u32 newLR = state.pc + 4;
         state.pc = state.lr & ~0x3ULL;
-        state.pc -= 4;
-        if (code.lk) state.lr = newLR;
+        if (LK) state.lr = newLR;
+    }
+    else {
+        state.pc += 4;
     }
 }
 
+void Interpreter::bclrx(Instruction code)
+{
+    code.lk ? bclrx_t<true>(code) : bclrx_t<false>(code);
+}
+
 void Interpreter::crand(Instruction code)
 {
     const u8 value = state.cr.getBit(code.crba) & state.cr.getBit(code.crbb);
@@ -132,6 +174,7 @@ void Interpreter::sc(Instruction code)
     default:
         unknown("sc");
     }
+    state.pc += 4;
 }
 
 void Interpreter::td(Instruction code)
@@ -154,5 +197,67 @@ void Interpreter::twi(Instruction code)
     unknown("twi");
 }
 
+bool Interpreter::detectSpin(CachedInstruction* entry, u32 addr)
+{
+    const Instruction code = entry->code;
+    if (code.opcode != 0x10 || code.bd >= 0) {
+        return false;
+    }
+
+    // Loops crossing the page boundary are not detected
+    const u32 start = addr + (code.bd << 2);
+    if ((start >> InstructionCache::PAGE_SHIFT) != (addr >> InstructionCache::PAGE_SHIFT)) {
+        return false;
+    }
+    if (!isSpinLoop(start, addr)) {
+        return false;
+    }
+    entry->handler = &Interpreter::spin_bcx;
+    return true;
+}
+
+void Interpreter::spin_bcx(Instruction code)
+{
+    const u32 branch = state.pc;
+    bcx_t<false, false>(code);
+    if (state.pc != branch + (code.bd << 2)) {
+        state.spin.reset();
+        return;
+    }
+
+    // Back off, watching the first load of the loop body
+    const u32 loadAddr = findSpinLoad(branch + (code.bd << 2));
+    if (!loadAddr) {
+        return;
+    }
+    const Instruction load = { nucleus.memory.read32(loadAddr) };
+    state.spin.wait(branch, getSpinLoadAddress(load, state.gpr[load.ra], state.gpr[load.rb]));
+}
+
+Interpreter::Handler Interpreter::specializeBranch(Handler handler, Instruction code)
+{
+    if (handler == &Interpreter::bx) {
+        static const Handler variants[] = {
+            &Interpreter::bx_t<false, false>, &Interpreter::bx_t<false, true>,
+            &Interpreter::bx_t<true, false>,  &Interpreter::bx_t<true, true>,
+        };
+        return variants[code.lk << 1 | code.aa];
+    }
+    if (handler == &Interpreter::bcx) {
+        static const Handler variants[] = {
+            &Interpreter::bcx_t<false, false>, &Interpreter::bcx_t<false, true>,
+            &Interpreter::bcx_t<true, false>,  &Interpreter::bcx_t<true, true>,
+        };
+        return variants[code.lk << 1 | code.aa];
+    }
+    if (handler == &Interpreter::bcctrx) {
+        return code.lk ? &Interpreter::bcctrx_t<true> : &Interpreter::bcctrx_t<false>;
+    }
+    if (handler == &Interpreter::bclrx) {
+        return code.lk ? &Interpreter::bclrx_t<true> : &Interpreter::bclrx_t<false>;
+    }
+    return handler;
+}
+
 }  // namespace ppu
 }  // namespace cpu
@@ -0,0 +1,152 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter_cache.h"
+#include "nucleus/config.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_tables.h"
+
+#include <algorithm>
+
+namespace cpu {
+namespace ppu {
+
+InstructionCache::InstructionCache() : m_generation(0), m_epoch(0)
+{
+}
+
+InstructionCache::~InstructionCache()
+{
+    clear();
+    delete[] m_pages;
+}
+
+void InstructionCache::init()
+{
+    if (!m_pages) {
+        m_pages = new std::atomic<Page*>[PAGE_COUNT]();
+    }
+}
+
+void InstructionCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pages) {
+        for (u32 i = 0; i < PAGE_COUNT; i++) {
+            Page* page = m_pages[i].exchange(nullptr);
+            if (page) {
+                nucleus.memory.clearPageFlags(i << PAGE_SHIFT, PAGE_CODE);
+                delete page;
+            }
+        }
+    }
+    for (const RetiredPage& retired : m_retired) {
+        delete retired.page;
+    }
+    m_retired.clear();
+}
+
+void InstructionCache::reclaim()
+{
+    u64 oldest = EPOCH_NONE;
+    for (const std::atomic<u64>* epoch : m_readers) {
+        oldest = std::min(oldest, epoch->load());
+    }
+    auto it = std::remove_if(m_retired.begin(), m_retired.end(), [&](const RetiredPage& retired) {
+        if (retired.epoch < oldest) {
+            delete retired.page;
+            return true;
+        }
+        return false;
+    });
+    m_retired.erase(it, m_retired.end());
+}
+
+void InstructionCache::addReader(std::atomic<u64>* epoch)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    epoch->store(EPOCH_NONE);
+    m_readers.push_back(epoch);
+}
+
+void InstructionCache::removeReader(std::atomic<u64>* epoch)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_readers.erase(std::remove(m_readers.begin(), m_readers.end(), epoch), m_readers.end());
+    reclaim();
+}
+
+InstructionCache::Page* InstructionCache::build(u32 addr)
+{
+    // Writes to this page will invalidate it from now on
+    nucleus.memory.setPageFlags(addr, PAGE_CODE);
+    const u32 generation = m_generation.load(std::memory_order_acquire);
+
+    Page* page = new Page();
+    for (u32 i = 0; i < PAGE_ENTRIES; i++) {
+        Instruction code = { nucleus.memory.read32(addr + 4*i) };
+        page->entries[i].handler = get_entry(code).interpret;
+        if (code.opcode == 0x04) {
+            page->entries[i].handler = Interpreter::selectHandler(page->entries[i].handler);
+        }
+        else {
+            page->entries[i].handler = Interpreter::specialize(page->entries[i].handler, code);
+        }
+        page->entries[i].code = code;
+        page->entries[i].flags = 0;
+        page->entries[i].size = 1;
+        if (code.is_branch() || code.opcode == 0x11 /* sc */) {
+            page->entries[i].flags |= CACHED_BLOCK_END;
+        }
+    }
+
+    // Replace common sequences by superinstructions, without crossing the page boundary.
+    // Entries following the first one are kept, since they might be branch targets.
+    for (u32 i = 0; i < PAGE_ENTRIES; i++) {
+        Interpreter::fuse(&page->entries[i], PAGE_ENTRIES - i);
+    }
+
+    // Back off in loops polling memory written by other threads
+    if (config.ppuSpinDetection) {
+        for (u32 i = 0; i < PAGE_ENTRIES; i++) {
+            Interpreter::detectSpin(&page->entries[i], addr + 4*i);
+        }
+    }
+
+    // Publish the page unless another thread already did it
+    Page* expected = nullptr;
+    if (!m_pages[addr >> PAGE_SHIFT].compare_exchange_strong(expected, page, std::memory_order_acq_rel)) {
+        delete page;
+        return expected;
+    }
+
+    // The page was written while it was being decoded, drop it after this lookup
+    if (generation != m_generation.load(std::memory_order_acquire)) {
+        invalidate(addr);
+    }
+    return page;
+}
+
+void InstructionCache::invalidate(u32 addr)
+{
+    if (!m_pages) {
+        return;
+    }
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+
+    // Readers announcing a later epoch can no longer find the page
+    Page* page = m_pages[addr >> PAGE_SHIFT].exchange(nullptr);
+    if (page) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RetiredPage retired;
+        retired.page = page;
+        retired.epoch = m_epoch.fetch_add(1);
+        m_retired.push_back(retired);
+        reclaim();
+    }
+}
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,122 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/ppu/ppu_instruction.h"
+#include "nucleus/cpu/ppu/interpreter/ppu_interpreter.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace cpu {
+namespace ppu {
+
+enum CachedInstructionFlags {
+    CACHED_BLOCK_END = (1 << 0),  // Instruction ends a basic block and updates the PC by itself
+};
+
+/**
+ * Predecoded instruction:
+ * Resolved interpreter handler along with the instruction word already converted
+ * to host endianness, so that its fields can be extracted without touching guest memory.
+ */
+struct CachedInstruction
+{
+    void (Interpreter::*handler)(Instruction);
+    Instruction code;
+    u16 flags;
+    u16 size;  // Number of instructions executed by the handler
+};
+
+/**
+ * Instruction cache:
+ * Guest memory is split in pages of 4 KB. Each page is predecoded as a whole the first
+ * time any of its instructions gets executed, and discarded whenever the page is written.
+ * Pages are shared by all PPU threads and published atomically, so lookups are lock-free.
+ */
+class InstructionCache
+{
+public:
+    static const u32 PAGE_SHIFT = 12;
+    static const u32 PAGE_SIZE = 1 << PAGE_SHIFT;
+    static const u32 PAGE_COUNT = 1 << (32 - PAGE_SHIFT);
+    static const u32 PAGE_ENTRIES = PAGE_SIZE / 4;
+
+    struct Page
+    {
+        CachedInstruction entries[PAGE_ENTRIES];
+    };
+
+private:
+    std::atomic<Page*>* m_pages = nullptr;
+
+    // Invalidated pages might still be in use by other threads: They are retired along with the
+    // current epoch, and freed once every reader has announced a later epoch (or no epoch at all).
+    struct RetiredPage
+    {
+        Page* page;
+        u64 epoch;
+    };
+    std::mutex m_mutex;
+    std::vector<RetiredPage> m_retired;
+    std::vector<std::atomic<u64>*> m_readers;
+    std::atomic<u64> m_epoch;
+
+    // Free the retired pages no reader might still hold (requires the mutex)
+    void reclaim();
+
+    // Incremented on every invalidation to detect writes racing with a page build
+    std::atomic<u32> m_generation;
+
+    Page* build(u32 addr);
+
+public:
+    InstructionCache();
+    ~InstructionCache();
+
+    void init();
+    void clear();
+
+    // Get the predecoded page containing the address
+    Page* getPage(u32 addr) {
+        Page* page = m_pages[addr >> PAGE_SHIFT].load(std::memory_order_acquire);
+        if (!page) {
+            page = build(addr & ~(PAGE_SIZE - 1));
+        }
+        return page;
+    }
+
+    // Get the predecoded instruction at the address
+    const CachedInstruction& get(u32 addr) {
+        return getPage(addr)->entries[(addr & (PAGE_SIZE - 1)) >> 2];
+    }
+
+    // Discard the page containing the address
+    void invalidate(u32 addr);
+
+    /**
+     * Readers:
+     * Threads announce the epoch in which they start looking up pages, and clear it once they hold no
+     * pointer to them anymore. Announcements and lookups are sequentially consistent, so pages retired
+     * after an announcement are not freed while the reader is active.
+     */
+    static const u64 EPOCH_NONE = ~0ULL;
+
+    void addReader(std::atomic<u64>* epoch);
+    void removeReader(std::atomic<u64>* epoch);
+
+    void enter(std::atomic<u64>& epoch) {
+        epoch.store(m_epoch.load());
+    }
+    void leave(std::atomic<u64>& epoch) {
+        epoch.store(EPOCH_NONE);
+    }
+};
+
+}  // namespace ppu
+}  // namespace cpu
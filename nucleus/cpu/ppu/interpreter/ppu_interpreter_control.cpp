@@ -54,12 +54,13 @@ u64& getRegBySPR(State& state, u32 spr)
     const u32 n = (spr >> 5) | ((spr & 0x1f) << 5);
 
     switch (n) {
-    case 0x001: return state.xer.XER;
+    case 0x001: state.xer.sync(); return state.xer.XER;
     case 0x008: return state.lr;
     case 0x009: return state.ctr;
     }
 
     //unknown("GetRegBySPR error: Unknown SPR!");
+    state.xer.sync();
     return state.xer.XER;
 }
 
@@ -73,6 +74,7 @@ u64& getRegBySPR(State& state, u32 spr)
 
 void Interpreter::mfocrf(Instruction code)
 {
+    state.cr.sync();
     state.gpr[code.rd] = bitReverse32(state.cr.CR);
 }
 
@@ -83,6 +85,7 @@ void Interpreter::mfspr(Instruction code)
 
 void Interpreter::mtocrf(Instruction code)
 {
+    state.cr.sync();
     if (code.l11) {
         u32 n = 0, count = 0;
         for (int i = 0; i < 8; i++) {
@@ -156,13 +159,15 @@ void Interpreter::dcbz(Instruction code)
     void* cache_line = nucleus.memory.ptr(addr & ~127);
     if (cache_line) {
         memset(cache_line, 0, 128);
+        nucleus.memory.checkWrite(addr & ~127, 128);
     }
     // TODO: _mm_fence();
 }
 
 void Interpreter::icbi(Instruction code)
 {
-    // Nothing to do in the interpreter.
+    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    nucleus.cell.ppu_icache.invalidate(addr);
 }
 
 void Interpreter::eciwx(Instruction code)
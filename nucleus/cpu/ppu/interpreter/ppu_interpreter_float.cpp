@@ -13,19 +13,6 @@ namespace ppu {
 #define DOUBLE_FRAC 0x000FFFFFFFFFFFFFULL
 #define DOUBLE_ZERO 0x0000000000000000ULL
 
-// Return the corresponding FPSCR flags for the FPRF field for a given double value
-u32 getFPRFlags(PPU_FPR reg)
-{
-    const f64 value = reg._f64;
-    switch (std::fpclassify(value)) {
-    case FP_NAN:        return FPR_FPRF_QNAN;
-    case FP_INFINITE:   return std::signbit(value) ? FPR_FPRF_NINF : FPR_FPRF_PINF;
-    case FP_SUBNORMAL:  return std::signbit(value) ? FPR_FPRF_ND : FPR_FPRF_PD;
-    case FP_ZERO:       return std::signbit(value) ? FPR_FPRF_NZ : FPR_FPRF_PZ;
-    default:            return std::signbit(value) ? FPR_FPRF_NN : FPR_FPRF_PN;
-    }
-}
-
 /**
  * PPC64 Instructions:
  *  - UISA: Floating-Point Instructions (Section: 4.2.2)
@@ -35,7 +22,7 @@ void Interpreter::fabsx(Instruction code)
 {
     const f64 value = state.fpr[code.frb]._f64;
     state.fpr[code.frd]._f64 = (value < 0.0) ? -value : value;
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::faddx(Instruction code)
@@ -53,8 +40,8 @@ void Interpreter::faddx(Instruction code)
     } else {
         state.fpr[code.frd]._f64 = t;
     }
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPRF >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::faddsx(Instruction code)
@@ -73,8 +60,8 @@ void Interpreter::faddsx(Instruction code)
         state.fpr[code.frd]._f64 = t;
     }
     state.fpr[code.frd]._f64 = static_cast<f32>(state.fpr[code.frd]._f64);
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fcfidx(Instruction code)
@@ -91,7 +78,7 @@ void Interpreter::fcfidx(Instruction code)
         state.fpscr.FR = abs(bfi) > abs(bi);
     }
     state.fpr[code.frd]._f64 = bf;
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fcmpo(Instruction code)
@@ -109,7 +96,7 @@ void Interpreter::fcmpo(Instruction code)
         }
         state.fpscr.FX = 1;
     }
-    state.fpscr.FPRF = (1 << (3 - compareResult));
+    state.fpscr.setFPRF(1 << (3 - compareResult));
     state.cr.setField(code.crfd, 1 << compareResult);
 }
 
@@ -121,7 +108,7 @@ void Interpreter::fcmpu(Instruction code)
             state.fpscr.setException(FPSCR_VXSNAN);
         }
     }
-    state.fpscr.FPRF = (1 << (3 - compareResult));
+    state.fpscr.setFPRF(1 << (3 - compareResult));
     state.cr.setField(code.crfd, 1 << compareResult);
 }
 
@@ -182,7 +169,7 @@ void Interpreter::fctidx(Instruction code)
     }
 
     state.fpr[code.frd]._u64 = r;
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fctidzx(Instruction code)
@@ -222,7 +209,7 @@ void Interpreter::fctidzx(Instruction code)
     }
 
     state.fpr[code.frd]._u64 = r;
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fctiwx(Instruction code)
@@ -283,7 +270,7 @@ void Interpreter::fctiwx(Instruction code)
     }
 
     (u64&)state.fpr[code.frd] = r;
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fctiwzx(Instruction code)
@@ -319,7 +306,7 @@ void Interpreter::fctiwzx(Instruction code)
     }
 
     (u64&)state.fpr[code.frd] = value;
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fdivx(Instruction code)
@@ -349,8 +336,8 @@ void Interpreter::fdivx(Instruction code)
             state.fpr[code.frd]._f64 = state.fpr[code.fra]._f64 / state.fpr[code.frb]._f64;
         }
     }
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fdivsx(Instruction code)
@@ -381,42 +368,42 @@ void Interpreter::fdivsx(Instruction code)
             state.fpr[code.frd]._f64 = (f32)(state.fpr[code.fra]._f64 / state.fpr[code.frb]._f64);
         }
     }
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fmaddx(Instruction code)
 {
     state.fpr[code.frd]._f64 = state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64 + state.fpr[code.frb]._f64;
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fmaddsx(Instruction code)
 {
     state.fpr[code.frd]._f64 = static_cast<f32>(state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64 + state.fpr[code.frb]._f64);
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fmrx(Instruction code)
 {
     state.fpr[code.frd] = state.fpr[code.frb];
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fmsubx(Instruction code)
 {
     state.fpr[code.frd]._f64 = state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64 - state.fpr[code.frb]._f64;
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fmsubsx(Instruction code)
 {
     state.fpr[code.frd]._f64 = static_cast<f32>(state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64 - state.fpr[code.frb]._f64);
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fmulx(Instruction code)
@@ -427,16 +414,16 @@ void Interpreter::fmulx(Instruction code)
         state.fpr[code.frd]._u64 = PPU_FPR::FPR_NAN;
         state.fpscr.FI = 0;
         state.fpscr.FR = 0;
-        state.fpscr.FPRF = FPSCR_FPRF::FPR_FPRF_QNAN;
+        state.fpscr.setFPRF(FPR_FPRF_QNAN);
     }
     else {
         if (state.fpr[code.fra].isSNaN() || state.fpr[code.frc].isSNaN()) {
             state.fpscr.setException(FPSCR_VXSNAN);
         }
         state.fpr[code.frd]._f64 = state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64;
-        state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
+        state.updateFPRF(state.fpr[code.frd]._f64);
     }
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fmulsx(Instruction code)
@@ -456,48 +443,48 @@ void Interpreter::fmulsx(Instruction code)
     }
     state.fpscr.FI = 0;
     state.fpscr.FR = 0;
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fnabsx(Instruction code)
 {
     state.fpr[code.frd]._f64 = -::fabs(state.fpr[code.frb]._f64);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fnegx(Instruction code)
 {
     state.fpr[code.frd]._f64 = -state.fpr[code.frb]._f64;
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fnmaddx(Instruction code)
 {
     state.fpr[code.frd]._f64 = -(state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64 + state.fpr[code.frb]._f64);
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fnmaddsx(Instruction code)
 {
     state.fpr[code.frd]._f64 = static_cast<f32>(-(state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64 + state.fpr[code.frb]._f64));
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fnmsubx(Instruction code)
 {
     state.fpr[code.frd]._f64 = -(state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64 - state.fpr[code.frb]._f64);
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fnmsubsx(Instruction code)
 {
     state.fpr[code.frd]._f64 = static_cast<f32>(-(state.fpr[code.fra]._f64 * state.fpr[code.frc]._f64 - state.fpr[code.frb]._f64));
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fresx(Instruction code)
@@ -506,7 +493,7 @@ void Interpreter::fresx(Instruction code)
         state.fpscr.setException(FPSCR_ZX);
     }
     state.fpr[code.frd]._f64 = static_cast<f32>(1.0 / state.fpr[code.frb]._f64);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::frspx(Instruction code)
@@ -527,7 +514,7 @@ void Interpreter::frspx(Instruction code)
         state.fpscr.FI = 0;
     }
     state.fpr[code.frd]._f64 = r;
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
+    state.updateFPRF(state.fpr[code.frd]._f64);
 }
 
 void Interpreter::frsqrtex(Instruction code)
@@ -536,65 +523,72 @@ void Interpreter::frsqrtex(Instruction code)
         state.fpscr.setException(FPSCR_ZX);
     }
     state.fpr[code.frd]._f64 = 1.0 / sqrt(state.fpr[code.frb]._f64);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fselx(Instruction code)
 {
     state.fpr[code.frd] = state.fpr[code.fra]._f64 >= 0.0 ? state.fpr[code.frc] : state.fpr[code.frb];
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fsqrtx(Instruction code)
 {
     state.fpr[code.frd]._f64 = sqrt(state.fpr[code.frb]._f64);
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fsqrtsx(Instruction code)
 {
     state.fpr[code.frd]._f64 = static_cast<f32>(sqrt(state.fpr[code.frb]._f64));
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fsubx(Instruction code)
 {
     state.fpr[code.frd]._f64 = state.fpr[code.fra]._f64 - state.fpr[code.frb]._f64;
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::fsubsx(Instruction code)
 {
     state.fpr[code.frd]._f64 = static_cast<f32>(state.fpr[code.fra]._f64 - state.fpr[code.frb]._f64);
-    state.fpscr.FPRF = getFPRFlags(state.fpr[code.frd]);
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    state.updateFPRF(state.fpr[code.frd]._f64);
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::mcrfs(Instruction code)
 {
     u64 mask = (1ULL << code.crbd);
+    state.cr.sync();
+    state.fpscr.sync();
     state.cr.CR &= ~mask;
     state.cr.CR |= state.fpscr.FPSCR & mask;
 }
 
 void Interpreter::mffsx(Instruction code)
 {
+    state.fpscr.sync();
     (u64&)state.fpr[code.frd] = state.fpscr.FPSCR;
-    if (code.rc) { state.cr.setField(1, state.fpscr.FPSCR >> 28); }
+    if (code.rc) { state.updateCR1(); }
 }
 
 void Interpreter::mtfsb0x(Instruction code)
 {
+    state.fpscr.sync();
     state.fpscr.FPSCR &= ~(1ULL << code.crbd);
+    state.updateHostFloatEnv();
     if (code.rc) unknown("mtfsb0.");
 }
 
 void Interpreter::mtfsb1x(Instruction code)
 {
+    state.fpscr.sync();
     state.fpscr.FPSCR |= (1ULL << code.crbd);
+    state.updateHostFloatEnv();
     if (code.rc) unknown("mtfsb1.");
 }
 
@@ -602,8 +596,10 @@ void Interpreter::mtfsfix(Instruction code)
 {
     const u32 mask = 0xF << (code.crfd * 4);
     const u32 value = (code.imm & 0xF) << (code.crfd * 4);
+    state.fpscr.sync();
     state.fpscr.FPSCR &= ~mask;
     state.fpscr.FPSCR |= value;
+    state.updateHostFloatEnv();
     if (code.rc) unknown("mtfsfi.");
 }
 
@@ -615,7 +611,9 @@ void Interpreter::mtfsfx(Instruction code)
             mask |= 0xf << (i * 4);
         }
     }
+    state.fpscr.sync();
     state.fpscr.FPSCR = (state.fpscr.FPSCR & ~mask) | ((u32&)state.fpr[code.frb] & mask);
+    state.updateHostFloatEnv();
     if (code.rc) unknown("mtfsf.");
 }
 
@@ -0,0 +1,148 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+#include "ppu_interpreter_cache.h"
+#include "nucleus/emulator.h"
+
+namespace cpu {
+namespace ppu {
+
+// PowerPC Rotation-related functions
+inline u64 rotl64(const u64 x, const u8 n) { return (x << n) | (x >> (64 - n)); }
+inline u64 rotl32(const u32 x, const u8 n) { return rotl64((u64)x | ((u64)x << 32), n); }
+
+// Instruction matchers
+static inline bool isLis(Instruction code) { return code.opcode == 0x0F && code.ra == 0; }
+static inline bool isOri(Instruction code) { return code.opcode == 0x18; }
+static inline bool isAddi(Instruction code) { return code.opcode == 0x0E; }
+static inline bool isRlwinm(Instruction code) { return code.opcode == 0x15; }
+static inline bool isCmpwi(Instruction code) { return code.opcode == 0x0B && code.l10 == 0; }
+static inline bool isStw(Instruction code) { return code.opcode == 0x24; }
+static inline bool isStwu(Instruction code) { return code.opcode == 0x25; }
+static inline bool isStd(Instruction code) { return code.opcode == 0x3E && code.op62 == 0; }
+static inline bool isStdu(Instruction code) { return code.opcode == 0x3E && code.op62 == 1; }
+static inline bool isLwz(Instruction code) { return code.opcode == 0x20; }
+static inline bool isMflr(Instruction code) { return code.opcode == 0x1F && code.op31 == 0x153 && code.spr == 0x100; }
+static inline bool isMtctr(Instruction code) { return code.opcode == 0x1F && code.op31 == 0x1D3 && code.spr == 0x120; }
+static inline bool isBctr(Instruction code) { return code.opcode == 0x13 && code.op19 == 0x210 && (code.bo & 0x14) == 0x14 && code.lk == 0; }
+
+bool Interpreter::fuse(CachedInstruction* entry, u32 count)
+{
+    const Instruction c0 = entry[0].code;
+    const Instruction c1 = (count > 1) ? entry[1].code : Instruction{0};
+    const Instruction c2 = (count > 2) ? entry[2].code : Instruction{0};
+    const Instruction c3 = (count > 3) ? entry[3].code : Instruction{0};
+
+    auto replace = [&](void (Interpreter::*handler)(Instruction), u16 size, u16 flags) {
+        entry[0].handler = handler;
+        entry[0].size = size;
+        entry[0].flags = flags;
+        return true;
+    };
+
+    // Constant materialization
+    if (isLis(c0) && c0.rd != 0 && count > 1) {
+        if (isOri(c1) && c1.rs == c0.rd) {
+            return replace(&Interpreter::fused_lis_ori, 2, 0);
+        }
+        if (isAddi(c1) && c1.ra == c0.rd) {
+            return replace(&Interpreter::fused_lis_addi, 2, 0);
+        }
+    }
+
+    // Bit test
+    if (isRlwinm(c0) && count > 1 && isCmpwi(c1) && c1.ra == c0.ra) {
+        return replace(&Interpreter::fused_rlwinm_cmpwi, 2, 0);
+    }
+
+    // Function prologue
+    if (isMflr(c0) && count > 2) {
+        if (isStw(c1) && c1.rs == c0.rd && c1.ra != 0 && isStwu(c2) && c2.ra != 0) {
+            return replace(&Interpreter::fused_mflr_stw_stwu, 3, 0);
+        }
+        if (isStd(c1) && c1.rs == c0.rd && c1.ra != 0 && isStdu(c2) && c2.ra != 0) {
+            return replace(&Interpreter::fused_mflr_std_stdu, 3, 0);
+        }
+    }
+
+    // Indirect call through a function descriptor, optionally loading its TOC
+    if (isLwz(c0) && count > 2) {
+        if (isMtctr(c1) && c1.rs == c0.rd && isBctr(c2)) {
+            return replace(&Interpreter::fused_lwz_mtctr_bctr, 3, CACHED_BLOCK_END);
+        }
+        if (count > 3 && isLwz(c1) && c1.rd != c0.rd && isMtctr(c2) && c2.rs == c0.rd && isBctr(c3)) {
+            return replace(&Interpreter::fused_lwz_mtctr_bctr, 4, CACHED_BLOCK_END);
+        }
+    }
+    return false;
+}
+
+void Interpreter::fused_lis_ori(Instruction code)
+{
+    const Instruction ori = m_entry[1].code;
+    state.gpr[code.rd] = (code.simm << 16);
+    state.gpr[ori.ra] = state.gpr[code.rd] | ori.uimm;
+    m_fusedHits[FUSED_LIS_ORI]++;
+}
+
+void Interpreter::fused_lis_addi(Instruction code)
+{
+    const Instruction addi = m_entry[1].code;
+    state.gpr[code.rd] = (code.simm << 16);
+    state.gpr[addi.rd] = (s64)state.gpr[code.rd] + addi.simm;
+    m_fusedHits[FUSED_LIS_ADDI]++;
+}
+
+void Interpreter::fused_rlwinm_cmpwi(Instruction code)
+{
+    const Instruction cmpwi = m_entry[1].code;
+    const u64 value = rotl32(state.gpr[code.rs], code.sh) & rotateMask[32 + code.mb][32 + code.me];
+    state.gpr[code.ra] = value;
+    if (code.rc) { state.updateCR0(value); }
+    state.cr.updateField(cmpwi.crfd, (s32)value, (s32)cmpwi.simm);
+    m_fusedHits[FUSED_RLWINM_CMPWI]++;
+}
+
+void Interpreter::fused_mflr_stw_stwu(Instruction code)
+{
+    const Instruction stw = m_entry[1].code;
+    const Instruction stwu = m_entry[2].code;
+    state.gpr[code.rd] = state.lr;
+    nucleus.memory.write32(state.gpr[stw.ra] + stw.d, state.gpr[stw.rs]);
+    const u32 addr = state.gpr[stwu.ra] + stwu.d;
+    nucleus.memory.write32(addr, state.gpr[stwu.rs]);
+    state.gpr[stwu.ra] = addr;
+    m_fusedHits[FUSED_MFLR_STW_STWU]++;
+}
+
+void Interpreter::fused_mflr_std_stdu(Instruction code)
+{
+    const Instruction std = m_entry[1].code;
+    const Instruction stdu = m_entry[2].code;
+    state.gpr[code.rd] = state.lr;
+    nucleus.memory.write64(state.gpr[std.ra] + (std.ds << 2), state.gpr[std.rs]);
+    const u32 addr = state.gpr[stdu.ra] + (stdu.ds << 2);
+    nucleus.memory.write64(addr, state.gpr[stdu.rs]);
+    state.gpr[stdu.ra] = addr;
+    m_fusedHits[FUSED_MFLR_STD_STDU]++;
+}
+
+void Interpreter::fused_lwz_mtctr_bctr(Instruction code)
+{
+    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    state.gpr[code.rd] = nucleus.memory.read32(addr);
+    if (m_entry->size == 4) {
+        const Instruction lwz = m_entry[1].code;
+        const u32 tocAddr = lwz.ra ? state.gpr[lwz.ra] + lwz.d : lwz.d;
+        state.gpr[lwz.rd] = nucleus.memory.read32(tocAddr);
+    }
+    state.ctr = state.gpr[code.rd];
+    state.pc = state.ctr & ~0x3ULL;
+    m_fusedHits[FUSED_LWZ_MTCTR_BCTR]++;
+}
+
+}  // namespace ppu
+}  // namespace cpu
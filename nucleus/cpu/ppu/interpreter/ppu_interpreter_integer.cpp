@@ -19,11 +19,17 @@ inline u8 rotl8(const u8 x, const u8 n) { return (x << n) | (x >> (8 - n)); }
  *  - UISA: Integer instructions (Section: 4.2.1)
  */
 
-void Interpreter::addx(Instruction code)
+template <bool RC>
+void Interpreter::addx_t(Instruction code)
 {
     state.gpr[code.rd] = state.gpr[code.ra] + state.gpr[code.rb];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.rd]); }
+}
+
+void Interpreter::addx(Instruction code)
+{
     if (code.oe) unknown("addo");
+    code.rc ? addx_t<true>(code) : addx_t<false>(code);
 }
 
 void Interpreter::addcx(Instruction code)
@@ -31,8 +37,8 @@ void Interpreter::addcx(Instruction code)
     const s64 gpra = state.gpr[code.ra];
     const s64 gprb = state.gpr[code.rb];
     state.gpr[code.rd] = gpra + gprb;
-    state.xer.CA = isCarry(gpra, gprb);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    state.updateCA(gpra, gprb);
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
     if (code.oe) unknown("addco");
 }
 
@@ -40,127 +46,177 @@ void Interpreter::addex(Instruction code)
 {
     const u64 gpra = state.gpr[code.ra];
     const u64 gprb = state.gpr[code.rb];
-    if (state.xer.CA) {
+    if (state.xer.getCA()) {
         if (gpra == ~0ULL) {
             state.gpr[code.rd] = gprb;
-            state.xer.CA = 1;
+            state.xer.setCA(1);
         }
         else {
             state.gpr[code.rd] = gpra + 1 + gprb;
-            state.xer.CA = isCarry(gpra + 1, gprb);
+            state.updateCA(gpra + 1, gprb);
         }
     }
     else {
         state.gpr[code.rd] = gpra + gprb;
-        state.xer.CA = isCarry(gpra, gprb);
+        state.updateCA(gpra, gprb);
     }
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
     if (code.oe) unknown("addeo");
 }
 
+template <bool RA>
+void Interpreter::addi_t(Instruction code)
+{
+    state.gpr[code.rd] = RA ? ((s64)state.gpr[code.ra] + code.simm) : code.simm;
+}
+
 void Interpreter::addi(Instruction code)
 {
-    state.gpr[code.rd] = code.ra ? ((s64)state.gpr[code.ra] + code.simm) : code.simm;
+    code.ra ? addi_t<true>(code) : addi_t<false>(code);
 }
 
 void Interpreter::addic(Instruction code)
 {
     const u64 gpra = state.gpr[code.ra];
     state.gpr[code.rd] = gpra + code.simm;
-    state.xer.CA = isCarry(gpra, code.simm);
+    state.updateCA(gpra, code.simm);
 }
 
 void Interpreter::addic_(Instruction code)
 {
     const u64 gpra = state.gpr[code.ra];
     state.gpr[code.rd] = gpra + code.simm;
-    state.xer.CA = isCarry(gpra, code.simm);
-    state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0);
+    state.updateCA(gpra, code.simm);
+    state.updateCR0(state.gpr[code.rd]);
+}
+
+template <bool RA>
+void Interpreter::addis_t(Instruction code)
+{
+    state.gpr[code.rd] = RA ? ((s64)state.gpr[code.ra] + (code.simm << 16)) : (code.simm << 16);
 }
 
 void Interpreter::addis(Instruction code)
 {
-    state.gpr[code.rd] = code.ra ? ((s64)state.gpr[code.ra] + (code.simm << 16)) : (code.simm << 16);
+    code.ra ? addis_t<true>(code) : addis_t<false>(code);
 }
 
 void Interpreter::addmex(Instruction code)
 {
     const s64 gpra = state.gpr[code.ra];
-    state.gpr[code.rd] = gpra + state.xer.CA - 1;
-    state.xer.CA |= gpra != 0;
+    const u8 ca = state.xer.getCA();
+    state.gpr[code.rd] = gpra + ca - 1;
+    state.xer.setCA(ca | (gpra != 0));
     if (code.oe) unknown("addmeo");
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::addzex(Instruction code)
 {
     const u64 gpra = state.gpr[code.ra];
-    state.gpr[code.rd] = gpra + state.xer.CA;
-    state.xer.CA = isCarry(gpra, state.xer.CA);
+    const u8 ca = state.xer.getCA();
+    state.gpr[code.rd] = gpra + ca;
+    state.updateCA(gpra, ca);
     if (code.oe) unknown("addzeo");
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
-void Interpreter::andx(Instruction code)
+template <bool RC>
+void Interpreter::andx_t(Instruction code)
 {
     state.gpr[code.ra] = state.gpr[code.rs] & state.gpr[code.rb];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::andcx(Instruction code)
+void Interpreter::andx(Instruction code)
+{
+    code.rc ? andx_t<true>(code) : andx_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::andcx_t(Instruction code)
 {
     state.gpr[code.ra] = state.gpr[code.rs] & ~state.gpr[code.rb];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::andcx(Instruction code)
+{
+    code.rc ? andcx_t<true>(code) : andcx_t<false>(code);
 }
 
 void Interpreter::andi_(Instruction code)
 {
     state.gpr[code.ra] = state.gpr[code.rs] & code.uimm;
-    state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0);
+    state.updateCR0(state.gpr[code.ra]);
 }
 
 void Interpreter::andis_(Instruction code)
 {
     state.gpr[code.ra] = state.gpr[code.rs] & (code.uimm << 16);
-    state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0);
+    state.updateCR0(state.gpr[code.ra]);
 }
 
-void Interpreter::cmp(Instruction code)
+template <bool L>
+void Interpreter::cmp_t(Instruction code)
 {
-    if (code.l10) {
+    if (L) {
         state.cr.updateField(code.crfd, (s64)state.gpr[code.ra], (s64)state.gpr[code.rb]);
     } else {
         state.cr.updateField(code.crfd, (s32)state.gpr[code.ra], (s32)state.gpr[code.rb]);
     }
 }
 
-void Interpreter::cmpi(Instruction code)
+void Interpreter::cmp(Instruction code)
 {
-    if (code.l10) {
+    code.l10 ? cmp_t<true>(code) : cmp_t<false>(code);
+}
+
+template <bool L>
+void Interpreter::cmpi_t(Instruction code)
+{
+    if (L) {
         state.cr.updateField(code.crfd, (s64)state.gpr[code.ra], (s64)code.simm);
     } else {
         state.cr.updateField(code.crfd, (s32)state.gpr[code.ra], (s32)code.simm);
     }
 }
 
-void Interpreter::cmpl(Instruction code)
+void Interpreter::cmpi(Instruction code)
 {
-    if (code.l10) {
+    code.l10 ? cmpi_t<true>(code) : cmpi_t<false>(code);
+}
+
+template <bool L>
+void Interpreter::cmpl_t(Instruction code)
+{
+    if (L) {
         state.cr.updateField(code.crfd, (u64)state.gpr[code.ra], (u64)state.gpr[code.rb]);
     } else {
         state.cr.updateField(code.crfd, (u32)state.gpr[code.ra], (u32)state.gpr[code.rb]);
     }
 }
 
-void Interpreter::cmpli(Instruction code)
+void Interpreter::cmpl(Instruction code)
 {
-    if (code.l10) {
+    code.l10 ? cmpl_t<true>(code) : cmpl_t<false>(code);
+}
+
+template <bool L>
+void Interpreter::cmpli_t(Instruction code)
+{
+    if (L) {
         state.cr.updateField(code.crfd, (u64)state.gpr[code.ra], (u64)code.uimm);
     } else {
         state.cr.updateField(code.crfd, (u32)state.gpr[code.ra], (u32)code.uimm);
     }
 }
 
+void Interpreter::cmpli(Instruction code)
+{
+    code.l10 ? cmpli_t<true>(code) : cmpli_t<false>(code);
+}
+
 void Interpreter::cntlzdx(Instruction code)
 {
     int i;
@@ -170,10 +226,11 @@ void Interpreter::cntlzdx(Instruction code)
         }
     }
     state.gpr[code.ra] = i;
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::cntlzwx(Instruction code)
+template <bool RC>
+void Interpreter::cntlzwx_t(Instruction code)
 {
     int i;
     for (i = 0; i < 32; i++) {
@@ -182,7 +239,12 @@ void Interpreter::cntlzwx(Instruction code)
         }
     }
     state.gpr[code.ra] = i;
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::cntlzwx(Instruction code)
+{
+    code.rc ? cntlzwx_t<true>(code) : cntlzwx_t<false>(code);
 }
 
 void Interpreter::divdx(Instruction code)
@@ -196,7 +258,7 @@ void Interpreter::divdx(Instruction code)
     else {
         state.gpr[code.rd] = gpra / gprb;
     }
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::divdux(Instruction code)
@@ -210,7 +272,7 @@ void Interpreter::divdux(Instruction code)
     else {
         state.gpr[code.rd] = gpra / gprb;
     }
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::divwx(Instruction code)
@@ -224,7 +286,7 @@ void Interpreter::divwx(Instruction code)
     else {
         state.gpr[code.rd] = (u32)(gpra / gprb);
     }
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::divwux(Instruction code)
@@ -238,31 +300,49 @@ void Interpreter::divwux(Instruction code)
     else {
         state.gpr[code.rd] = gpra / gprb;
     }
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::eqvx(Instruction code)
 {
     state.gpr[code.ra] = ~(state.gpr[code.rs] ^ state.gpr[code.rb]);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::extsbx(Instruction code)
+template <bool RC>
+void Interpreter::extsbx_t(Instruction code)
 {
     state.gpr[code.ra] = (s64)(s8)state.gpr[code.rs];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::extshx(Instruction code)
+void Interpreter::extsbx(Instruction code)
+{
+    code.rc ? extsbx_t<true>(code) : extsbx_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::extshx_t(Instruction code)
 {
     state.gpr[code.ra] = (s64)(s16)state.gpr[code.rs];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::extswx(Instruction code)
+void Interpreter::extshx(Instruction code)
+{
+    code.rc ? extshx_t<true>(code) : extshx_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::extswx_t(Instruction code)
 {
     state.gpr[code.ra] = (s64)(s32)state.gpr[code.rs];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::extswx(Instruction code)
+{
+    code.rc ? extswx_t<true>(code) : extswx_t<false>(code);
 }
 
 void Interpreter::mulhdx(Instruction code)
@@ -274,7 +354,7 @@ void Interpreter::mulhdx(Instruction code)
 #elif defined(NUCLEUS_PLATFORM_LINUX) || defined(NUCLEUS_PLATFORM_OSX)
     __asm__("mulq %[b]" : "=d" (state.gpr[code.rd]) : [a] "a" (a), [b] "rm" (b));
 #endif
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::mulhdux(Instruction code)
@@ -286,7 +366,7 @@ void Interpreter::mulhdux(Instruction code)
 #elif defined(NUCLEUS_PLATFORM_LINUX) || defined(NUCLEUS_PLATFORM_OSX)
     __asm__("imulq %[b]" : "=d" (state.gpr[code.rd]) : [a] "a" (a), [b] "rm" (b));
 #endif
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::mulhwx(Instruction code)
@@ -294,7 +374,7 @@ void Interpreter::mulhwx(Instruction code)
     s32 a = state.gpr[code.ra];
     s32 b = state.gpr[code.rb];
     state.gpr[code.rd] = ((s64)a * (s64)b) >> 32;
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::mulhwux(Instruction code)
@@ -302,13 +382,13 @@ void Interpreter::mulhwux(Instruction code)
     u32 a = state.gpr[code.ra];
     u32 b = state.gpr[code.rb];
     state.gpr[code.rd] = ((u64)a * (u64)b) >> 32;
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::mulldx(Instruction code)
 {
     state.gpr[code.rd] = (s64)((s64)state.gpr[code.ra] * (s64)state.gpr[code.rb]);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
     if (code.oe) unknown("mulldo");
 }
 
@@ -317,43 +397,67 @@ void Interpreter::mulli(Instruction code)
     state.gpr[code.rd] = (s64)state.gpr[code.ra] * code.simm;
 }
 
-void Interpreter::mullwx(Instruction code)
+template <bool RC>
+void Interpreter::mullwx_t(Instruction code)
 {
     state.gpr[code.rd] = (s64)((s64)(s32)state.gpr[code.ra] * (s64)(s32)state.gpr[code.rb]);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.rd]); }
+}
+
+void Interpreter::mullwx(Instruction code)
+{
     if (code.oe) unknown("mullwo");
+    code.rc ? mullwx_t<true>(code) : mullwx_t<false>(code);
 }
 
 void Interpreter::nandx(Instruction code)
 {
     state.gpr[code.ra] = ~(state.gpr[code.rs] & state.gpr[code.rb]);
 
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::negx(Instruction code)
+template <bool RC>
+void Interpreter::negx_t(Instruction code)
 {
     state.gpr[code.rd] = 0 - state.gpr[code.ra];
+    if (RC) { state.updateCR0(state.gpr[code.rd]); }
+}
+
+void Interpreter::negx(Instruction code)
+{
     if (code.oe) unknown("nego");
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    code.rc ? negx_t<true>(code) : negx_t<false>(code);
 }
 
-void Interpreter::norx(Instruction code)
+template <bool RC>
+void Interpreter::norx_t(Instruction code)
 {
     state.gpr[code.ra] = ~(state.gpr[code.rs] | state.gpr[code.rb]);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::orx(Instruction code)
+void Interpreter::norx(Instruction code)
+{
+    code.rc ? norx_t<true>(code) : norx_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::orx_t(Instruction code)
 {
     state.gpr[code.ra] = state.gpr[code.rs] | state.gpr[code.rb];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::orx(Instruction code)
+{
+    code.rc ? orx_t<true>(code) : orx_t<false>(code);
 }
 
 void Interpreter::orcx(Instruction code)
 {
     state.gpr[code.ra] = state.gpr[code.rs] | ~state.gpr[code.rb];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
 void Interpreter::ori(Instruction code)
@@ -378,7 +482,7 @@ void Interpreter::rldc_lr(Instruction code)
         // rldclx
         state.gpr[code.ra] = rotl64(state.gpr[code.rs], rotate) & rotateMask[mb][63];
     }
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
 void Interpreter::rldicx(Instruction code)
@@ -386,23 +490,35 @@ void Interpreter::rldicx(Instruction code)
     const u32 sh = code.sh | (code.sh_ << 5);
     const u32 mb = code.mb | (code.mb_ << 5);
     state.gpr[code.ra] = rotl64(state.gpr[code.rs], sh) & rotateMask[mb][63-sh];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::rldiclx(Instruction code)
+template <bool RC>
+void Interpreter::rldiclx_t(Instruction code)
 {
     const u32 sh = code.sh | (code.sh_ << 5);
     const u32 mb = code.mb | (code.mb_ << 5);
     state.gpr[code.ra] = rotl64(state.gpr[code.rs], sh) & rotateMask[mb][63];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::rldicrx(Instruction code)
+void Interpreter::rldiclx(Instruction code)
+{
+    code.rc ? rldiclx_t<true>(code) : rldiclx_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::rldicrx_t(Instruction code)
 {
     const u32 sh = code.sh | (code.sh_ << 5);
     const u32 me = code.me_ | (code.me__ << 5);
     state.gpr[code.ra] = rotl64(state.gpr[code.rs], sh) & rotateMask[0][me];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::rldicrx(Instruction code)
+{
+    code.rc ? rldicrx_t<true>(code) : rldicrx_t<false>(code);
 }
 
 void Interpreter::rldimix(Instruction code)
@@ -411,43 +527,67 @@ void Interpreter::rldimix(Instruction code)
     const u32 mb = code.mb | (code.mb_ << 5);
     const u64 mask = rotateMask[mb][63-sh];
     state.gpr[code.ra] = (state.gpr[code.ra] & ~mask) | (rotl64(state.gpr[code.rs], sh) & mask);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::rlwimix(Instruction code)
+template <bool RC>
+void Interpreter::rlwimix_t(Instruction code)
 {
     const u64 r = rotl32(state.gpr[code.rs], code.sh);
     const u64 m = rotateMask[32 + code.mb][32 + code.me];
     state.gpr[code.ra] = (r & m) | (state.gpr[code.ra] & ~m);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::rlwinmx(Instruction code)
+void Interpreter::rlwimix(Instruction code)
+{
+    code.rc ? rlwimix_t<true>(code) : rlwimix_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::rlwinmx_t(Instruction code)
 {
     state.gpr[code.ra] = rotl32(state.gpr[code.rs], code.sh) & rotateMask[32 + code.mb][32 + code.me];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::rlwinmx(Instruction code)
+{
+    code.rc ? rlwinmx_t<true>(code) : rlwinmx_t<false>(code);
 }
 
 void Interpreter::rlwnmx(Instruction code)
 {
     state.gpr[code.ra] = rotl32(state.gpr[code.rs], state.gpr[code.rb] & 0x1f) & rotateMask[32 + code.mb][32 + code.me];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::sldx(Instruction code)
+template <bool RC>
+void Interpreter::sldx_t(Instruction code)
 {
     const u64 shift = state.gpr[code.rb] & 0x7F;
     state.gpr[code.ra] = (shift & 0x40) ? 0 : (state.gpr[code.rs] << shift);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::slwx(Instruction code)
+void Interpreter::sldx(Instruction code)
+{
+    code.rc ? sldx_t<true>(code) : sldx_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::slwx_t(Instruction code)
 {
     u32 n = state.gpr[code.rb] & 0x1f;
     u32 r = rotl32((u32)state.gpr[code.rs], n);
     u32 m = (state.gpr[code.rb] & 0x20) ? 0 : rotateMask[32][63 - n];
     state.gpr[code.ra] = r & m;
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::slwx(Instruction code)
+{
+    code.rc ? slwx_t<true>(code) : slwx_t<false>(code);
 }
 
 void Interpreter::sradx(Instruction code)
@@ -456,22 +596,28 @@ void Interpreter::sradx(Instruction code)
     u8 shift = state.gpr[code.rb] & 127;
     if (shift > 63) {
         state.gpr[code.ra] = 0 - (RS < 0);
-        state.xer.CA = (RS < 0);
+        state.xer.setCA(RS < 0);
     }
     else {
         state.gpr[code.ra] = RS >> shift;
-        state.xer.CA = (RS < 0) & ((state.gpr[code.ra] << shift) != RS);
+        state.xer.setCA((RS < 0) & ((state.gpr[code.ra] << shift) != RS));
     }
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::sradix(Instruction code)
+template <bool RC>
+void Interpreter::sradix_t(Instruction code)
 {
     const s64 rs = state.gpr[code.rs];
     const u32 sh = code.sh | (code.sh_ << 5);
     state.gpr[code.ra] = rs >> sh;
-    state.xer.CA = (rs < 0) & ((state.gpr[code.ra] << sh) != rs);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    state.xer.setCA((rs < 0) & ((state.gpr[code.ra] << sh) != rs));
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::sradix(Instruction code)
+{
+    code.rc ? sradix_t<true>(code) : sradix_t<false>(code);
 }
 
 void Interpreter::srawx(Instruction code)
@@ -480,44 +626,68 @@ void Interpreter::srawx(Instruction code)
     u8 shift = state.gpr[code.rb] & 63;
     if (shift > 31) {
         state.gpr[code.ra] = 0 - (gprs < 0);
-        state.xer.CA = (gprs < 0);
+        state.xer.setCA(gprs < 0);
     }
     else {
         state.gpr[code.ra] = gprs >> shift;
-        state.xer.CA = (gprs < 0) & ((state.gpr[code.ra] << shift) != gprs);
+        state.xer.setCA((gprs < 0) & ((state.gpr[code.ra] << shift) != gprs));
     }
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::srawix(Instruction code)
+template <bool RC>
+void Interpreter::srawix_t(Instruction code)
 {
     s32 gprs = (u32)state.gpr[code.rs];
     state.gpr[code.ra] = gprs >> code.sh;
-    state.xer.CA = (gprs < 0) & ((u32)(state.gpr[code.ra] << code.sh) != gprs);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    state.xer.setCA((gprs < 0) & ((u32)(state.gpr[code.ra] << code.sh) != gprs));
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::srdx(Instruction code)
+void Interpreter::srawix(Instruction code)
+{
+    code.rc ? srawix_t<true>(code) : srawix_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::srdx_t(Instruction code)
 {
     const u64 shift = state.gpr[code.rb] & 0x7F;
     state.gpr[code.ra] = (shift & 0x40) ? 0 : (state.gpr[code.rs] >> shift);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::srwx(Instruction code)
+void Interpreter::srdx(Instruction code)
+{
+    code.rc ? srdx_t<true>(code) : srdx_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::srwx_t(Instruction code)
 {
     u32 n = state.gpr[code.rb] & 0x1f;
     u32 m = (state.gpr[code.rb] & 0x20) ? 0 : rotateMask[32 + n][63];
     u32 r = rotl32((u32)state.gpr[code.rs], 64 - n);
     state.gpr[code.ra] = r & m;
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
 }
 
-void Interpreter::subfx(Instruction code)
+void Interpreter::srwx(Instruction code)
+{
+    code.rc ? srwx_t<true>(code) : srwx_t<false>(code);
+}
+
+template <bool RC>
+void Interpreter::subfx_t(Instruction code)
 {
     state.gpr[code.rd] = state.gpr[code.rb] - state.gpr[code.ra];
+    if (RC) { state.updateCR0(state.gpr[code.rd]); }
+}
+
+void Interpreter::subfx(Instruction code)
+{
     if (code.oe) unknown("subfo");
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    code.rc ? subfx_t<true>(code) : subfx_t<false>(code);
 }
 
 void Interpreter::subfcx(Instruction code)
@@ -525,18 +695,19 @@ void Interpreter::subfcx(Instruction code)
     const u64 gpra = state.gpr[code.ra];
     const s64 gprb = state.gpr[code.rb];
     state.gpr[code.rd] = ~gpra + gprb + 1;
-    state.xer.CA = isCarry(~gpra, gprb, 1);
+    state.updateCA(~gpra, gprb, 1);
     if (code.oe) unknown("subfco");
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::subfex(Instruction code)
 {
     const u64 gpra = state.gpr[code.ra];
     const s64 gprb = state.gpr[code.rb];
-    state.gpr[code.rd] = ~gpra + gprb + state.xer.CA;
-    state.xer.CA = isCarry(~gpra, gprb, state.xer.CA);
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    const u8 ca = state.xer.getCA();
+    state.gpr[code.rd] = ~gpra + gprb + ca;
+    state.updateCA(~gpra, gprb, ca);
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
     if (code.oe) unknown("subfeo");
 }
 
@@ -546,31 +717,39 @@ void Interpreter::subfic(Instruction code)
     const u64 IMM = (s64)code.simm;
     state.gpr[code.rd] = ~gpra + IMM + 1;
 
-    state.xer.CA = isCarry(~gpra, IMM, 1);
+    state.updateCA(~gpra, IMM, 1);
 }
 
 void Interpreter::subfmex(Instruction code)
 {
     const u64 gpra = state.gpr[code.ra];
-    state.gpr[code.rd] = ~gpra + state.xer.CA + ~0ULL;
-    state.xer.CA = isCarry(~gpra, state.xer.CA, ~0ULL);
+    const u8 ca = state.xer.getCA();
+    state.gpr[code.rd] = ~gpra + ca + ~0ULL;
+    state.updateCA(~gpra, ca, ~0ULL);
     if (code.oe) unknown("subfmeo");
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
 void Interpreter::subfzex(Instruction code)
 {
     const u64 gpra = state.gpr[code.ra];
-    state.gpr[code.rd] = ~gpra + state.xer.CA;
-    state.xer.CA = isCarry(~gpra, state.xer.CA);
+    const u8 ca = state.xer.getCA();
+    state.gpr[code.rd] = ~gpra + ca;
+    state.updateCA(~gpra, ca);
     if (code.oe) unknown("subfzeo");
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.rd], (s64)0); }
+    if (code.rc) { state.updateCR0(state.gpr[code.rd]); }
 }
 
-void Interpreter::xorx(Instruction code)
+template <bool RC>
+void Interpreter::xorx_t(Instruction code)
 {
     state.gpr[code.ra] = state.gpr[code.rs] ^ state.gpr[code.rb];
-    if (code.rc) { state.cr.updateField(0, (s64)state.gpr[code.ra], (s64)0); }
+    if (RC) { state.updateCR0(state.gpr[code.ra]); }
+}
+
+void Interpreter::xorx(Instruction code)
+{
+    code.rc ? xorx_t<true>(code) : xorx_t<false>(code);
 }
 
 void Interpreter::xori(Instruction code)
@@ -583,5 +762,45 @@ void Interpreter::xoris(Instruction code)
     state.gpr[code.ra] = state.gpr[code.rs] ^ (code.uimm << 16);
 }
 
+Interpreter::Handler Interpreter::specializeInteger(Handler handler, Instruction code)
+{
+    struct Variants {
+        Handler generic;
+        Handler variant[2];  // Field cleared, field set
+    };
+#define VARIANTS(name) { &Interpreter::name, { &Interpreter::name##_t<false>, &Interpreter::name##_t<true> } }
+    static const Variants variantsRC[] = {
+        VARIANTS(addx), VARIANTS(subfx), VARIANTS(negx), VARIANTS(andx), VARIANTS(andcx),
+        VARIANTS(orx), VARIANTS(xorx), VARIANTS(norx), VARIANTS(rlwinmx), VARIANTS(rlwimix),
+        VARIANTS(rldiclx), VARIANTS(rldicrx), VARIANTS(extsbx), VARIANTS(extshx), VARIANTS(extswx),
+        VARIANTS(mullwx), VARIANTS(slwx), VARIANTS(srwx), VARIANTS(sldx), VARIANTS(srdx),
+        VARIANTS(srawix), VARIANTS(sradix), VARIANTS(cntlzwx),
+    };
+    static const Variants variantsRA[] = {
+        VARIANTS(addi), VARIANTS(addis),
+    };
+    static const Variants variantsL[] = {
+        VARIANTS(cmp), VARIANTS(cmpi), VARIANTS(cmpl), VARIANTS(cmpli),
+    };
+#undef VARIANTS
+
+    for (const auto& entry : variantsRC) {
+        if (entry.generic == handler) {
+            return entry.variant[code.rc];
+        }
+    }
+    for (const auto& entry : variantsRA) {
+        if (entry.generic == handler) {
+            return entry.variant[code.ra != 0];
+        }
+    }
+    for (const auto& entry : variantsL) {
+        if (entry.generic == handler) {
+            return entry.variant[code.l10];
+        }
+    }
+    return handler;
+}
+
 }  // namespace ppu
 }  // namespace cpu
@@ -23,9 +23,15 @@ namespace ppu {
  *  - VEA: Memory Synchronization Instructions (Section: 4.3.2)
  */
 
+template <bool RA>
+void Interpreter::lbz_t(Instruction code)
+{
+    state.gpr[code.rd] = nucleus.memory.read8(RA ? state.gpr[code.ra] + code.d : code.d);
+}
+
 void Interpreter::lbz(Instruction code)
 {
-    state.gpr[code.rd] = nucleus.memory.read8(code.ra ? state.gpr[code.ra] + code.d : code.d);
+    code.ra ? lbz_t<true>(code) : lbz_t<false>(code);
 }
 
 void Interpreter::lbzu(Instruction code)
@@ -42,24 +48,34 @@ void Interpreter::lbzux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::lbzx(Instruction code)
+template <bool RA>
+void Interpreter::lbzx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.gpr[code.rd] = nucleus.memory.read8(addr);
 }
 
-void Interpreter::ld(Instruction code)
+void Interpreter::lbzx(Instruction code)
+{
+    code.ra ? lbzx_t<true>(code) : lbzx_t<false>(code);
+}
+
+template <bool RA>
+void Interpreter::ld_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + (code.ds << 2) : (code.ds << 2);
+    const u32 addr = RA ? state.gpr[code.ra] + (code.ds << 2) : (code.ds << 2);
     state.gpr[code.rd] = nucleus.memory.read64(addr);
 }
 
+void Interpreter::ld(Instruction code)
+{
+    code.ra ? ld_t<true>(code) : ld_t<false>(code);
+}
+
 void Interpreter::ldarx(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
-    state.gpr[code.rd] = nucleus.memory.read64(addr);
-    state.reserve_addr = addr;
-    state.reserve_value = re64(state.gpr[code.rd]);
+    state.gpr[code.rd] = nucleus.memory.reservations.load64(state.reservation, addr);
 }
 
 void Interpreter::ldbrx(Instruction code)
@@ -82,18 +98,30 @@ void Interpreter::ldux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::ldx(Instruction code)
+template <bool RA>
+void Interpreter::ldx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.gpr[code.rd] = nucleus.memory.read64(addr);
 }
 
-void Interpreter::lfd(Instruction code)
+void Interpreter::ldx(Instruction code)
+{
+    code.ra ? ldx_t<true>(code) : ldx_t<false>(code);
+}
+
+template <bool RA>
+void Interpreter::lfd_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     state.fpr[code.frd]._u64 = nucleus.memory.read64(addr);
 }
 
+void Interpreter::lfd(Instruction code)
+{
+    code.ra ? lfd_t<true>(code) : lfd_t<false>(code);
+}
+
 void Interpreter::lfdu(Instruction code)
 {
     const u32 addr = state.gpr[code.ra] + code.d;
@@ -108,19 +136,31 @@ void Interpreter::lfdux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::lfdx(Instruction code)
+template <bool RA>
+void Interpreter::lfdx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.fpr[code.frd]._u64 = nucleus.memory.read64(addr);
 }
 
-void Interpreter::lfs(Instruction code)
+void Interpreter::lfdx(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    code.ra ? lfdx_t<true>(code) : lfdx_t<false>(code);
+}
+
+template <bool RA>
+void Interpreter::lfs_t(Instruction code)
+{
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     const u32 value = nucleus.memory.read32(addr);
     state.fpr[code.frd]._f64 = (f32&)value;
 }
 
+void Interpreter::lfs(Instruction code)
+{
+    code.ra ? lfs_t<true>(code) : lfs_t<false>(code);
+}
+
 void Interpreter::lfsu(Instruction code)
 {
     const u32 addr = state.gpr[code.ra] + code.d;
@@ -137,19 +177,31 @@ void Interpreter::lfsux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::lfsx(Instruction code)
+template <bool RA>
+void Interpreter::lfsx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     const u32 value = nucleus.memory.read32(addr);
     state.fpr[code.frd]._f64 = (f32&)value;
 }
 
-void Interpreter::lha(Instruction code)
+void Interpreter::lfsx(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    code.ra ? lfsx_t<true>(code) : lfsx_t<false>(code);
+}
+
+template <bool RA>
+void Interpreter::lha_t(Instruction code)
+{
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     state.gpr[code.rd] = (s64)(s16)nucleus.memory.read16(addr);
 }
 
+void Interpreter::lha(Instruction code)
+{
+    code.ra ? lha_t<true>(code) : lha_t<false>(code);
+}
+
 void Interpreter::lhau(Instruction code)
 {
     const u32 addr = state.gpr[code.ra] + code.d;
@@ -164,24 +216,36 @@ void Interpreter::lhaux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::lhax(Instruction code)
+template <bool RA>
+void Interpreter::lhax_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.gpr[code.rd] = (s64)(s16)nucleus.memory.read16(addr);
 }
 
+void Interpreter::lhax(Instruction code)
+{
+    code.ra ? lhax_t<true>(code) : lhax_t<false>(code);
+}
+
 void Interpreter::lhbrx(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.gpr[code.rd] = re16(nucleus.memory.read16(addr));
 }
 
-void Interpreter::lhz(Instruction code)
+template <bool RA>
+void Interpreter::lhz_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     state.gpr[code.rd] = nucleus.memory.read16(addr);
 }
 
+void Interpreter::lhz(Instruction code)
+{
+    code.ra ? lhz_t<true>(code) : lhz_t<false>(code);
+}
+
 void Interpreter::lhzu(Instruction code)
 {
     const u32 addr = state.gpr[code.ra] + code.d;
@@ -196,12 +260,18 @@ void Interpreter::lhzux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::lhzx(Instruction code)
+template <bool RA>
+void Interpreter::lhzx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.gpr[code.rd] = nucleus.memory.read16(addr);
 }
 
+void Interpreter::lhzx(Instruction code)
+{
+    code.ra ? lhzx_t<true>(code) : lhzx_t<false>(code);
+}
+
 void Interpreter::lmw(Instruction code)
 {
     u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
@@ -242,17 +312,21 @@ void Interpreter::lswx(Instruction code)
     unknown("lswx");
 }
 
+template <bool RA>
+void Interpreter::lwa_t(Instruction code)
+{
+    state.gpr[code.rd] = (s64)(s32)nucleus.memory.read32(RA ? state.gpr[code.ra] + (code.ds << 2) : (code.ds << 2));
+}
+
 void Interpreter::lwa(Instruction code)
 {
-    state.gpr[code.rd] = (s64)(s32)nucleus.memory.read32(code.ra ? state.gpr[code.ra] + (code.ds << 2) : (code.ds << 2));
+    code.ra ? lwa_t<true>(code) : lwa_t<false>(code);
 }
 
 void Interpreter::lwarx(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
-    state.gpr[code.rd] = nucleus.memory.read32(addr);
-    state.reserve_addr = addr;
-    state.reserve_value = re32(state.gpr[code.rd]);
+    state.gpr[code.rd] = nucleus.memory.reservations.load32(state.reservation, addr);
 }
 
 void Interpreter::lwaux(Instruction code)
@@ -262,24 +336,36 @@ void Interpreter::lwaux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::lwax(Instruction code)
+template <bool RA>
+void Interpreter::lwax_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.gpr[code.rd] = (s64)(s32)nucleus.memory.read32(addr);
 }
 
+void Interpreter::lwax(Instruction code)
+{
+    code.ra ? lwax_t<true>(code) : lwax_t<false>(code);
+}
+
 void Interpreter::lwbrx(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.gpr[code.rd] = re32(nucleus.memory.read32(addr));
 }
 
-void Interpreter::lwz(Instruction code)
+template <bool RA>
+void Interpreter::lwz_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     state.gpr[code.rd] = nucleus.memory.read32(addr);
 }
 
+void Interpreter::lwz(Instruction code)
+{
+    code.ra ? lwz_t<true>(code) : lwz_t<false>(code);
+}
+
 void Interpreter::lwzu(Instruction code)
 {
     const u32 addr = state.gpr[code.ra] + code.d;
@@ -294,18 +380,30 @@ void Interpreter::lwzux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::lwzx(Instruction code)
+template <bool RA>
+void Interpreter::lwzx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     state.gpr[code.rd] = nucleus.memory.read32(addr);
 }
 
-void Interpreter::stb(Instruction code)
+void Interpreter::lwzx(Instruction code)
+{
+    code.ra ? lwzx_t<true>(code) : lwzx_t<false>(code);
+}
+
+template <bool RA>
+void Interpreter::stb_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     nucleus.memory.write8(addr, state.gpr[code.rs]);
 }
 
+void Interpreter::stb(Instruction code)
+{
+    code.ra ? stb_t<true>(code) : stb_t<false>(code);
+}
+
 void Interpreter::stbu(Instruction code)
 {
     const u32 addr = state.gpr[code.ra] + code.d;
@@ -320,28 +418,35 @@ void Interpreter::stbux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::stbx(Instruction code)
+template <bool RA>
+void Interpreter::stbx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     nucleus.memory.write8(addr, state.gpr[code.rs]);
 }
 
-void Interpreter::std(Instruction code)
+void Interpreter::stbx(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    code.ra ? stbx_t<true>(code) : stbx_t<false>(code);
+}
+
+template <bool RA>
+void Interpreter::std_t(Instruction code)
+{
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     nucleus.memory.write64(addr, state.gpr[code.rs]);
 }
 
+void Interpreter::std(Instruction code)
+{
+    code.ra ? std_t<true>(code) : std_t<false>(code);
+}
+
 void Interpreter::stdcx_(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
-    if (state.reserve_addr == addr) {
-        bool value = InterlockedCompareExchange((volatile u64*)(nucleus.memory.ptr(addr)), re64(state.gpr[code.rs]), state.reserve_value) == state.reserve_value;
-        state.cr.setBit(PPU_CR::CR_EQ, value);
-    }
-    else {
-        state.cr.setBit(PPU_CR::CR_EQ, false);
-    }
+    const bool success = nucleus.memory.reservations.store64(state.reservation, addr, state.gpr[code.rs]);
+    state.cr.setField(0, (success << PPU_CR::CR_EQ) | (state.xer.SO << PPU_CR::CR_SO));
 }
 
 void Interpreter::stdu(Instruction code)
@@ -358,18 +463,30 @@ void Interpreter::stdux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::stdx(Instruction code)
+template <bool RA>
+void Interpreter::stdx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     nucleus.memory.write64(addr, state.gpr[code.rs]);
 }
 
-void Interpreter::stfd(Instruction code)
+void Interpreter::stdx(Instruction code)
+{
+    code.ra ? stdx_t<true>(code) : stdx_t<false>(code);
+}
+
+template <bool RA>
+void Interpreter::stfd_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     nucleus.memory.write64(addr, state.fpr[code.frs]._u64);
 }
 
+void Interpreter::stfd(Instruction code)
+{
+    code.ra ? stfd_t<true>(code) : stfd_t<false>(code);
+}
+
 void Interpreter::stfdu(Instruction code)
 {
     const u32 addr = state.gpr[code.ra] + code.d;
@@ -384,25 +501,37 @@ void Interpreter::stfdux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::stfdx(Instruction code)
+template <bool RA>
+void Interpreter::stfdx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     nucleus.memory.write64(addr, state.fpr[code.frs]._u64);
 }
 
+void Interpreter::stfdx(Instruction code)
+{
+    code.ra ? stfdx_t<true>(code) : stfdx_t<false>(code);
+}
+
 void Interpreter::stfiwx(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     nucleus.memory.write32(addr, (u32&)state.fpr[code.frs]);
 }
 
-void Interpreter::stfs(Instruction code)
+template <bool RA>
+void Interpreter::stfs_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     const f32 value = state.fpr[code.frs]._f64;
     nucleus.memory.write32(addr, (u32&)value);
 }
 
+void Interpreter::stfs(Instruction code)
+{
+    code.ra ? stfs_t<true>(code) : stfs_t<false>(code);
+}
+
 void Interpreter::stfsu(Instruction code)
 {
     const u32 addr = state.gpr[code.ra] + code.d;
@@ -419,19 +548,31 @@ void Interpreter::stfsux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::stfsx(Instruction code)
+template <bool RA>
+void Interpreter::stfsx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     const f32 value = state.fpr[code.frs]._f64;
     nucleus.memory.write32(addr, (u32&)value);
 }
 
-void Interpreter::sth(Instruction code)
+void Interpreter::stfsx(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    code.ra ? stfsx_t<true>(code) : stfsx_t<false>(code);
+}
+
+template <bool RA>
+void Interpreter::sth_t(Instruction code)
+{
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     nucleus.memory.write16(addr, state.gpr[code.rs]);
 }
 
+void Interpreter::sth(Instruction code)
+{
+    code.ra ? sth_t<true>(code) : sth_t<false>(code);
+}
+
 void Interpreter::sthbrx(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
@@ -452,12 +593,18 @@ void Interpreter::sthux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::sthx(Instruction code)
+template <bool RA>
+void Interpreter::sthx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     nucleus.memory.write16(addr, state.gpr[code.rs]);
 }
 
+void Interpreter::sthx(Instruction code)
+{
+    code.ra ? sthx_t<true>(code) : sthx_t<false>(code);
+}
+
 void Interpreter::stmw(Instruction code)
 {
     u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
@@ -497,12 +644,18 @@ void Interpreter::stswx(Instruction code)
     unknown("stwsx");
 }
 
-void Interpreter::stw(Instruction code)
+template <bool RA>
+void Interpreter::stw_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + code.d : code.d;
+    const u32 addr = RA ? state.gpr[code.ra] + code.d : code.d;
     nucleus.memory.write32(addr, state.gpr[code.rs]);
 }
 
+void Interpreter::stw(Instruction code)
+{
+    code.ra ? stw_t<true>(code) : stw_t<false>(code);
+}
+
 void Interpreter::stwbrx(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
@@ -512,13 +665,8 @@ void Interpreter::stwbrx(Instruction code)
 void Interpreter::stwcx_(Instruction code)
 {
     const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
-    if (state.reserve_addr == addr) {
-        bool value = InterlockedCompareExchange((volatile u32*)(nucleus.memory.ptr(addr)), re32((u32)state.gpr[code.rs]), (u32)state.reserve_value) == (u32)state.reserve_value;
-        state.cr.setBit(PPU_CR::CR_EQ, value);
-    }
-    else {
-        state.cr.setBit(PPU_CR::CR_EQ, false);
-    }
+    const bool success = nucleus.memory.reservations.store32(state.reservation, addr, state.gpr[code.rs]);
+    state.cr.setField(0, (success << PPU_CR::CR_EQ) | (state.xer.SO << PPU_CR::CR_SO));
 }
 
 void Interpreter::stwu(Instruction code)
@@ -535,12 +683,18 @@ void Interpreter::stwux(Instruction code)
     state.gpr[code.ra] = addr;
 }
 
-void Interpreter::stwx(Instruction code)
+template <bool RA>
+void Interpreter::stwx_t(Instruction code)
 {
-    const u32 addr = code.ra ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
+    const u32 addr = RA ? state.gpr[code.ra] + state.gpr[code.rb] : state.gpr[code.rb];
     nucleus.memory.write32(addr, state.gpr[code.rs]);
 }
 
+void Interpreter::stwx(Instruction code)
+{
+    code.ra ? stwx_t<true>(code) : stwx_t<false>(code);
+}
+
 void Interpreter::eieio(Instruction code)
 {
     // TODO: _mm_fence();
@@ -556,5 +710,30 @@ void Interpreter::sync(Instruction code)
     // TODO: _mm_fence();
 }
 
+Interpreter::Handler Interpreter::specializeMemory(Handler handler, Instruction code)
+{
+    struct Variants {
+        Handler generic;
+        Handler variant[2];  // Field cleared, field set
+    };
+#define VARIANTS(name) { &Interpreter::name, { &Interpreter::name##_t<false>, &Interpreter::name##_t<true> } }
+    static const Variants variantsRA[] = {
+        VARIANTS(lbz), VARIANTS(lbzx), VARIANTS(ld), VARIANTS(ldx), VARIANTS(lfd), VARIANTS(lfdx),
+        VARIANTS(lfs), VARIANTS(lfsx), VARIANTS(lha), VARIANTS(lhax), VARIANTS(lhz),
+        VARIANTS(lhzx), VARIANTS(lwa), VARIANTS(lwax), VARIANTS(lwz), VARIANTS(lwzx),
+        VARIANTS(stb), VARIANTS(stbx), VARIANTS(std), VARIANTS(stdx), VARIANTS(stfd),
+        VARIANTS(stfdx), VARIANTS(stfs), VARIANTS(stfsx), VARIANTS(sth), VARIANTS(sthx),
+        VARIANTS(stw), VARIANTS(stwx),
+    };
+#undef VARIANTS
+
+    for (const auto& entry : variantsRA) {
+        if (entry.generic == handler) {
+            return entry.variant[code.ra != 0];
+        }
+    }
+    return handler;
+}
+
 }  // namespace ppu
 }  // namespace cpu
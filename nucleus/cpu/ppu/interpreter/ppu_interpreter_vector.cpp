@@ -17,7 +17,8 @@ inline u8 rotl8(const u8 x, const u8 n) { return (x << n) | (x >> (8 - n)); }
 
 float CheckVSCR_NJ(State& state, const f32 v)
 {
-    if (!state.vscr.NJ) {
+    // Denormals are already flushed by the host if requested
+    if (!state.vscr.NJ || state.hostNJ) {
         return v;
     }
     if (std::fpclassify(v) == FP_SUBNORMAL) {
@@ -164,6 +165,7 @@ void Interpreter::mfvscr(Instruction code)
 void Interpreter::mtvscr(Instruction code)
 {
     state.vscr.VSCR = state.vr[code.vb]._u32[0];
+    state.updateHostFloatEnv();
 }
 
 void Interpreter::stvebx(Instruction code)
@@ -1507,7 +1509,7 @@ void Interpreter::vsldoi(Instruction code)
     memcpy(tmpSRC, state.vr[code.vb]._u8, 16);
     memcpy(tmpSRC + 16, state.vr[code.va]._u8, 16);
     for (int b = 0; b < 16; b++) {
-        state.vr[code.vd]._u8[15 - b] = tmpSRC[31 - (b + code.sh)];
+        state.vr[code.vd]._u8[15 - b] = tmpSRC[31 - (b + code.vshb)];
     }
 }
 
@@ -0,0 +1,453 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_interpreter.h"
+
+#include <utility>
+
+#if defined(NUCLEUS_ARCH_X86_64)
+#include <smmintrin.h>
+#if defined(NUCLEUS_COMPILER_MSVC)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// Allow SSE4.1 intrinsics on specific functions without requiring it for the whole build
+#if defined(NUCLEUS_COMPILER_GCC) || defined(NUCLEUS_COMPILER_CLANG)
+#define SSE41 __attribute__((target("sse4.1")))
+#else
+#define SSE41
+#endif
+
+namespace cpu {
+namespace ppu {
+
+#if defined(NUCLEUS_ARCH_X86_64)
+
+static bool hostHasSSE41()
+{
+    // CPUID.01H:ECX.SSSE3[bit 9] and CPUID.01H:ECX.SSE4_1[bit 19]
+#if defined(NUCLEUS_COMPILER_MSVC)
+    int info[4];
+    __cpuid(info, 1);
+    const u32 ecx = info[2];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+#endif
+    return (ecx & (1 << 9)) && (ecx & (1 << 19));
+}
+
+/**
+ * Auxiliary functions:
+ * Lanes of PPU_VR are stored in host order, so element-wise operations map directly to SSE.
+ */
+SSE41 static inline __m128i loadi(const PPU_VR& vr) { return _mm_loadu_si128((const __m128i*)&vr); }
+SSE41 static inline __m128 loadf(const PPU_VR& vr) { return _mm_loadu_ps(vr._f32); }
+SSE41 static inline void storei(PPU_VR& vr, __m128i value) { _mm_storeu_si128((__m128i*)&vr, value); }
+SSE41 static inline void storef(PPU_VR& vr, __m128 value) { _mm_storeu_ps(vr._f32, value); }
+
+// Set VSCR[SAT] if the saturated and the modular results differ in any lane
+SSE41 static inline void checkSAT(State& state, __m128i saturated, __m128i modular)
+{
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(saturated, modular)) != 0xFFFF) {
+        state.vscr.SAT = 1;
+    }
+}
+
+// Signed 32-bit saturation of the lanes flagged by the sign bit of overflow
+SSE41 static inline __m128i saturateS32(State& state, __m128i a, __m128i result, __m128i overflow)
+{
+    if (!_mm_movemask_ps(_mm_castsi128_ps(overflow))) {
+        return result;
+    }
+    state.vscr.SAT = 1;
+    const __m128i limit = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(0x7FFFFFFF));
+    return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(result), _mm_castsi128_ps(limit), _mm_castsi128_ps(overflow)));
+}
+
+// Unsigned 32-bit saturated addition
+SSE41 static inline __m128i addsU32(State& state, __m128i a, __m128i b)
+{
+    const __m128i sum = _mm_add_epi32(a, b);
+    const __m128i valid = _mm_cmpeq_epi32(_mm_max_epu32(a, sum), sum);
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+        state.vscr.SAT = 1;
+    }
+    return _mm_or_si128(sum, _mm_xor_si128(valid, _mm_set1_epi32(-1)));
+}
+
+/**
+ * PPC64 Vector/SIMD Instructions (aka AltiVec) using SSE4.1:
+ *  - Vector UISA Instructions (Section: 4.2.x)
+ */
+
+SSE41 void Interpreter::vaddfp_sse41(Instruction code)
+{
+    storef(state.vr[code.vd], _mm_add_ps(loadf(state.vr[code.va]), loadf(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vaddsbs_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i result = _mm_adds_epi8(a, b);
+    checkSAT(state, result, _mm_add_epi8(a, b));
+    storei(state.vr[code.vd], result);
+}
+
+SSE41 void Interpreter::vaddshs_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i result = _mm_adds_epi16(a, b);
+    checkSAT(state, result, _mm_add_epi16(a, b));
+    storei(state.vr[code.vd], result);
+}
+
+SSE41 void Interpreter::vaddsws_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i sum = _mm_add_epi32(a, b);
+
+    // Overflow if both operands have the same sign and the result has a different one
+    const __m128i overflow = _mm_andnot_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, sum));
+    storei(state.vr[code.vd], saturateS32(state, a, sum, overflow));
+}
+
+SSE41 void Interpreter::vaddubm_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_add_epi8(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vaddubs_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i result = _mm_adds_epu8(a, b);
+    checkSAT(state, result, _mm_add_epi8(a, b));
+    storei(state.vr[code.vd], result);
+}
+
+SSE41 void Interpreter::vadduhm_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_add_epi16(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vadduhs_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i result = _mm_adds_epu16(a, b);
+    checkSAT(state, result, _mm_add_epi16(a, b));
+    storei(state.vr[code.vd], result);
+}
+
+SSE41 void Interpreter::vadduwm_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_add_epi32(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vadduws_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], addsU32(state, loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vand_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_and_si128(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vandc_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_andnot_si128(loadi(state.vr[code.vb]), loadi(state.vr[code.va])));
+}
+
+SSE41 void Interpreter::vavgub_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_avg_epu8(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vcmpeqfp_sse41(Instruction code)
+{
+    storef(state.vr[code.vd], _mm_cmpeq_ps(loadf(state.vr[code.va]), loadf(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vcmpequb_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_cmpeq_epi8(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vcmpequh_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_cmpeq_epi16(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vcmpequw_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_cmpeq_epi32(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vcmpgefp_sse41(Instruction code)
+{
+    storef(state.vr[code.vd], _mm_cmpge_ps(loadf(state.vr[code.va]), loadf(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vcmpgtfp_sse41(Instruction code)
+{
+    storef(state.vr[code.vd], _mm_cmpgt_ps(loadf(state.vr[code.va]), loadf(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vcmpgtsw_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_cmpgt_epi32(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vcmpgtuw_sse41(Instruction code)
+{
+    // Unsigned comparison by flipping the sign bits
+    const __m128i sign = _mm_set1_epi32(0x80000000);
+    const __m128i a = _mm_xor_si128(loadi(state.vr[code.va]), sign);
+    const __m128i b = _mm_xor_si128(loadi(state.vr[code.vb]), sign);
+    storei(state.vr[code.vd], _mm_cmpgt_epi32(a, b));
+}
+
+SSE41 void Interpreter::vmaddfp_sse41(Instruction code)
+{
+    const __m128 product = _mm_mul_ps(loadf(state.vr[code.va]), loadf(state.vr[code.vc]));
+    storef(state.vr[code.vd], _mm_add_ps(product, loadf(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vmaxfp_sse41(Instruction code)
+{
+    // Operands swapped to match std::max on NaN inputs
+    storef(state.vr[code.vd], _mm_max_ps(loadf(state.vr[code.vb]), loadf(state.vr[code.va])));
+}
+
+SSE41 void Interpreter::vmaxsw_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_max_epi32(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vmaxub_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_max_epu8(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vminfp_sse41(Instruction code)
+{
+    // Operands swapped to match std::min on NaN inputs
+    storef(state.vr[code.vd], _mm_min_ps(loadf(state.vr[code.vb]), loadf(state.vr[code.va])));
+}
+
+SSE41 void Interpreter::vminsw_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_min_epi32(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vminub_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_min_epu8(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vmrghw_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_unpackhi_epi32(loadi(state.vr[code.vb]), loadi(state.vr[code.va])));
+}
+
+SSE41 void Interpreter::vmrglw_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_unpacklo_epi32(loadi(state.vr[code.vb]), loadi(state.vr[code.va])));
+}
+
+SSE41 void Interpreter::vnmsubfp_sse41(Instruction code)
+{
+    const __m128 product = _mm_mul_ps(loadf(state.vr[code.va]), loadf(state.vr[code.vc]));
+    const __m128 result = _mm_sub_ps(product, loadf(state.vr[code.vb]));
+    storef(state.vr[code.vd], _mm_xor_ps(result, _mm_set1_ps(-0.0f)));
+}
+
+SSE41 void Interpreter::vnor_sse41(Instruction code)
+{
+    const __m128i result = _mm_or_si128(loadi(state.vr[code.va]), loadi(state.vr[code.vb]));
+    storei(state.vr[code.vd], _mm_xor_si128(result, _mm_set1_epi32(-1)));
+}
+
+SSE41 void Interpreter::vor_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_or_si128(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vperm_sse41(Instruction code)
+{
+    // Guest byte index i of (VA:VB) is found at host byte 15-(i%16) of VA (i < 16) or VB (i >= 16)
+    const __m128i c = loadi(state.vr[code.vc]);
+    const __m128i index = _mm_andnot_si128(c, _mm_set1_epi8(0x0F));
+    const __m128i fromA = _mm_shuffle_epi8(loadi(state.vr[code.va]), index);
+    const __m128i fromB = _mm_shuffle_epi8(loadi(state.vr[code.vb]), index);
+    const __m128i selectB = _mm_slli_epi16(c, 3);
+    storei(state.vr[code.vd], _mm_blendv_epi8(fromA, fromB, selectB));
+}
+
+SSE41 void Interpreter::vsel_sse41(Instruction code)
+{
+    const __m128i c = loadi(state.vr[code.vc]);
+    const __m128i fromB = _mm_and_si128(loadi(state.vr[code.vb]), c);
+    const __m128i fromA = _mm_andnot_si128(c, loadi(state.vr[code.va]));
+    storei(state.vr[code.vd], _mm_or_si128(fromA, fromB));
+}
+
+SSE41 void Interpreter::vsldoi_sse41(Instruction code)
+{
+    // Host order concatenation (VB:VA), the result starts 16-sh bytes into it
+    u8 buffer[32];
+    _mm_storeu_si128((__m128i*)&buffer[0], loadi(state.vr[code.vb]));
+    _mm_storeu_si128((__m128i*)&buffer[16], loadi(state.vr[code.va]));
+    storei(state.vr[code.vd], _mm_loadu_si128((const __m128i*)&buffer[16 - code.vshb]));
+}
+
+SSE41 void Interpreter::vspltw_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_set1_epi32(state.vr[code.vb]._u32[3 - code.vuimm]));
+}
+
+SSE41 void Interpreter::vsubfp_sse41(Instruction code)
+{
+    storef(state.vr[code.vd], _mm_sub_ps(loadf(state.vr[code.va]), loadf(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vsubsbs_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i result = _mm_subs_epi8(a, b);
+    checkSAT(state, result, _mm_sub_epi8(a, b));
+    storei(state.vr[code.vd], result);
+}
+
+SSE41 void Interpreter::vsubshs_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i result = _mm_subs_epi16(a, b);
+    checkSAT(state, result, _mm_sub_epi16(a, b));
+    storei(state.vr[code.vd], result);
+}
+
+SSE41 void Interpreter::vsubsws_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i diff = _mm_sub_epi32(a, b);
+
+    // Overflow if both operands have different signs and the result sign differs from the first one
+    const __m128i overflow = _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, diff));
+    storei(state.vr[code.vd], saturateS32(state, a, diff, overflow));
+}
+
+SSE41 void Interpreter::vsububm_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_sub_epi8(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vsububs_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i result = _mm_subs_epu8(a, b);
+    checkSAT(state, result, _mm_sub_epi8(a, b));
+    storei(state.vr[code.vd], result);
+}
+
+SSE41 void Interpreter::vsubuhm_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_sub_epi16(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vsubuhs_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i result = _mm_subs_epu16(a, b);
+    checkSAT(state, result, _mm_sub_epi16(a, b));
+    storei(state.vr[code.vd], result);
+}
+
+SSE41 void Interpreter::vsubuwm_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_sub_epi32(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+SSE41 void Interpreter::vsubuws_sse41(Instruction code)
+{
+    const __m128i a = loadi(state.vr[code.va]);
+    const __m128i b = loadi(state.vr[code.vb]);
+    const __m128i valid = _mm_cmpeq_epi32(_mm_max_epu32(a, b), a);
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+        state.vscr.SAT = 1;
+    }
+    storei(state.vr[code.vd], _mm_and_si128(_mm_sub_epi32(a, b), valid));
+}
+
+SSE41 void Interpreter::vsum4ubs_sse41(Instruction code)
+{
+    // Horizontal sum of each group of 4 bytes: u8 pairs into s16, then s16 pairs into s32
+    const __m128i pairs = _mm_maddubs_epi16(loadi(state.vr[code.va]), _mm_set1_epi8(1));
+    const __m128i sums = _mm_madd_epi16(pairs, _mm_set1_epi16(1));
+    storei(state.vr[code.vd], addsU32(state, loadi(state.vr[code.vb]), sums));
+}
+
+SSE41 void Interpreter::vxor_sse41(Instruction code)
+{
+    storei(state.vr[code.vd], _mm_xor_si128(loadi(state.vr[code.va]), loadi(state.vr[code.vb])));
+}
+
+Interpreter::Handler Interpreter::selectHandler(Handler handler)
+{
+    static const bool hasSSE41 = hostHasSSE41();
+    static const std::pair<Handler, Handler> handlersSSE41[] = {
+#define SSE41_HANDLER(name) { &Interpreter::name, &Interpreter::name##_sse41 }
+        SSE41_HANDLER(vaddfp),   SSE41_HANDLER(vaddsbs),  SSE41_HANDLER(vaddshs),  SSE41_HANDLER(vaddsws),
+        SSE41_HANDLER(vaddubm),  SSE41_HANDLER(vaddubs),  SSE41_HANDLER(vadduhm),  SSE41_HANDLER(vadduhs),
+        SSE41_HANDLER(vadduwm),  SSE41_HANDLER(vadduws),  SSE41_HANDLER(vand),     SSE41_HANDLER(vandc),
+        SSE41_HANDLER(vavgub),   SSE41_HANDLER(vcmpeqfp), SSE41_HANDLER(vcmpequb), SSE41_HANDLER(vcmpequh),
+        SSE41_HANDLER(vcmpequw), SSE41_HANDLER(vcmpgefp), SSE41_HANDLER(vcmpgtfp), SSE41_HANDLER(vcmpgtsw),
+        SSE41_HANDLER(vcmpgtuw), SSE41_HANDLER(vmaddfp),  SSE41_HANDLER(vmaxfp),   SSE41_HANDLER(vmaxsw),
+        SSE41_HANDLER(vmaxub),   SSE41_HANDLER(vminfp),   SSE41_HANDLER(vminsw),   SSE41_HANDLER(vminub),
+        SSE41_HANDLER(vmrghw),   SSE41_HANDLER(vmrglw),   SSE41_HANDLER(vnmsubfp), SSE41_HANDLER(vnor),
+        SSE41_HANDLER(vor),      SSE41_HANDLER(vperm),    SSE41_HANDLER(vsel),     SSE41_HANDLER(vsldoi),
+        SSE41_HANDLER(vspltw),   SSE41_HANDLER(vsubfp),   SSE41_HANDLER(vsubsbs),  SSE41_HANDLER(vsubshs),
+        SSE41_HANDLER(vsubsws),  SSE41_HANDLER(vsububm),  SSE41_HANDLER(vsububs),  SSE41_HANDLER(vsubuhm),
+        SSE41_HANDLER(vsubuhs),  SSE41_HANDLER(vsubuwm),  SSE41_HANDLER(vsubuws),  SSE41_HANDLER(vsum4ubs),
+        SSE41_HANDLER(vxor),
+#undef SSE41_HANDLER
+    };
+
+    if (hasSSE41) {
+        for (const auto& pair : handlersSSE41) {
+            if (pair.first == handler) {
+                return pair.second;
+            }
+        }
+    }
+    return handler;
+}
+
+#else
+
+Interpreter::Handler Interpreter::selectHandler(Handler handler)
+{
+    return handler;
+}
+
+#endif
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,165 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_cache.h"
+#include "nucleus/config.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/recompiler/ppu_recompiler.h"
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace cpu {
+namespace ppu {
+
+static const u32 CACHE_MAGIC = 0x4350504E;  // "NPPC"
+static const u32 CACHE_LLVM_VERSION = (LLVM_VERSION_MAJOR << 16) | LLVM_VERSION_MINOR;
+
+struct CacheHeader
+{
+    u32 magic;
+    u32 recompilerVersion;
+    u32 llvmVersion;
+    u32 size;       // Size of the contents following the header
+    u64 checksum;   // Hash of the contents following the header
+};
+
+// FNV-1a hash
+static u64 hashBytes(const void* data, size_t size, u64 hash=0xCBF29CE484222325ULL)
+{
+    const u8* bytes = (const u8*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+void ObjectCache::init(const std::string& path)
+{
+    m_path = path;
+    if (m_path.empty()) {
+        return;
+    }
+    if (llvm::sys::fs::create_directories(m_path)) {
+        nucleus.log.warning(LOG_CPU, "Could not create the PPU cache directory: %s", m_path.c_str());
+        m_path.clear();
+    }
+}
+
+std::string ObjectCache::getFilePath(const std::string& name) const
+{
+    return m_path + "/" + name;
+}
+
+u64 ObjectCache::getKey(u32 addr, u32 size)
+{
+    // Settings changing the generated code are part of the key
+    const u32 versions[] = { addr, size, RECOMPILER_VERSION, CACHE_LLVM_VERSION,
+        (u32)config.ppuInstrumentation, (u32)config.ppuSpinDetection };
+    const u64 hash = hashBytes(nucleus.memory.ptr(addr), size);
+
+    // Code is generated for the host CPU
+    const std::string cpu = llvm::sys::getHostCPUName();
+    return hashBytes(cpu.data(), cpu.size(), hashBytes(versions, sizeof(versions), hash));
+}
+
+bool ObjectCache::load(const std::string& name, std::string& data)
+{
+    std::ifstream file(getFilePath(name), std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    CacheHeader header;
+    if (!file.read((char*)&header, sizeof(header))) {
+        return false;
+    }
+    if (header.magic != CACHE_MAGIC ||
+        header.recompilerVersion != RECOMPILER_VERSION ||
+        header.llvmVersion != CACHE_LLVM_VERSION) {
+        return false;
+    }
+
+    data.resize(header.size);
+    if (!file.read(&data[0], header.size) || hashBytes(data.data(), data.size()) != header.checksum) {
+        nucleus.log.warning(LOG_CPU, "Discarding corrupted PPU cache file: %s", name.c_str());
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ObjectCache::save(const std::string& name, const std::string& data)
+{
+    CacheHeader header;
+    header.magic = CACHE_MAGIC;
+    header.recompilerVersion = RECOMPILER_VERSION;
+    header.llvmVersion = CACHE_LLVM_VERSION;
+    header.size = data.size();
+    header.checksum = hashBytes(data.data(), data.size());
+
+    // Write to a temporary file first, so other instances never read incomplete files
+    const std::string path = getFilePath(name);
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write((const char*)&header, sizeof(header));
+        file.write(data.data(), data.size());
+        if (!file) {
+            nucleus.log.warning(LOG_CPU, "Could not write PPU cache file: %s", name.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+bool ObjectCache::preload(const std::string& moduleName)
+{
+    std::string data;
+    if (!load(moduleName + ".obj", data)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_objects[moduleName] = std::move(data);
+    return true;
+}
+
+void ObjectCache::notifyObjectCompiled(const llvm::Module* module, const llvm::MemoryBuffer* obj)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    const std::string name = module->getModuleIdentifier() + ".obj";
+    save(name, std::string(obj->getBufferStart(), obj->getBufferSize()));
+}
+
+llvm::MemoryBuffer* ObjectCache::getObject(const llvm::Module* module)
+{
+    if (!isEnabled()) {
+        return nullptr;
+    }
+    std::string data;
+    const std::string name = module->getModuleIdentifier() + ".obj";
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_objects.find(module->getModuleIdentifier());
+        if (it != m_objects.end()) {
+            data = std::move(it->second);
+            m_objects.erase(it);
+        }
+    }
+    if (data.empty() && !load(name, data)) {
+        return nullptr;
+    }
+    return llvm::MemoryBuffer::getMemBufferCopy(data, name);
+}
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,63 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace cpu {
+namespace ppu {
+
+/**
+ * Recompiled code cache:
+ * Objects generated by MCJIT are stored on disk along with the list of functions of each segment,
+ * so booting the same executable again skips both the analysis and the code generation.
+ * Files are named after a hash of the segment bytes and address, and start with a header
+ * holding the recompiler and LLVM versions and a checksum of the contents, which are validated
+ * before using them. Any mismatch makes the segment be analyzed and recompiled again.
+ */
+class ObjectCache : public llvm::ObjectCache
+{
+    std::string m_path;
+
+    // Objects already read and validated, waiting to be requested by MCJIT
+    std::mutex m_mutex;
+    std::map<std::string, std::string> m_objects;
+
+    std::string getFilePath(const std::string& name) const;
+
+public:
+    // Set the directory holding the cached files, the cache is disabled if it is empty
+    void init(const std::string& path);
+
+    bool isEnabled() const {
+        return !m_path.empty();
+    }
+
+    // Get a key identifying the code of a segment and the recompiler (and settings) generating it
+    static u64 getKey(u32 addr, u32 size);
+
+    // Read and write cached files, returning false if they are missing or not valid
+    bool load(const std::string& name, std::string& data);
+    bool save(const std::string& name, const std::string& data);
+
+    // Read and validate the object of a module before creating its execution engine
+    bool preload(const std::string& moduleName);
+
+    // Called by MCJIT to store generated objects, and to look them up before generating code
+    virtual void notifyObjectCompiled(const llvm::Module* module, const llvm::MemoryBuffer* obj) override;
+    virtual llvm::MemoryBuffer* getObject(const llvm::Module* module) override;
+};
+
+}  // namespace ppu
+}  // namespace cpu
@@ -4,27 +4,48 @@
  */
 
 #include "ppu_decoder.h"
+#include "nucleus/config.h"
 #include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/analyzer/ppu_analyzer_imports.h"
+#include "nucleus/cpu/ppu/analyzer/ppu_analyzer_switch.h"
+#include "nucleus/cpu/ppu/ppu_cache.h"
+#include "nucleus/cpu/ppu/ppu_dispatch.h"
 #include "nucleus/cpu/ppu/ppu_instruction.h"
+#include "nucleus/cpu/ppu/ppu_profiler.h"
+#include "nucleus/cpu/ppu/ppu_spin.h"
 #include "nucleus/cpu/ppu/ppu_state.h"
 #include "nucleus/cpu/ppu/ppu_tables.h"
+#include "nucleus/cpu/ppu/ppu_tiering.h"
 
 #include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/Passes.h"
 #include "llvm/ExecutionEngine/MCJIT.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/PassManager.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Vectorize.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
 #include <queue>
+#include <set>
+#include <thread>
 
 namespace cpu {
 namespace ppu {
 
+// Inlining threshold of functions optimized with their profile (the default of LLVM is 225)
+static const int OPTIMIZED_INLINE_THRESHOLD = 500;
+
 /**
  * PPU Block methods
  */
@@ -38,7 +59,7 @@ bool Block::contains(u32 addr) const
 bool Block::is_split() const
 {
     const Instruction lastInstr = { nucleus.memory.read32(address + size - 4) };
-    if (!lastInstr.is_branch() || lastInstr.is_call() || (lastInstr.opcode == 0x13 && lastInstr.op19 == 0x210) /*bcctr*/) {
+    if (!lastInstr.is_branch() || lastInstr.is_call()) {
         return true;
     }
     return false;
@@ -56,14 +77,21 @@ void Function::do_register_analysis(Analyzer* status)
     status->analyzedFunctions.insert(address);
 
     // Analyze read/written registers
-    Block block = blocks[address];
+    // NOTE: Functions are analyzed concurrently, so the segment and the blocks are only looked up, never modified
+    auto it = blocks.find(address);
+    if (it == blocks.end()) {
+        return;
+    }
+    Block block = it->second;
     for (u32 i = block.address; i < (block.address + block.size); i += 4) {
-        Instruction code = { nucleus.memory.read32(i) };
+        const Instruction code = parent->getInstruction(i);
 
         // Check if called functions use any other registers
         if (code.is_call_known()) {
-            Function& targetFunc = parent->functions[code.get_target(i)];
-            targetFunc.do_register_analysis(status);
+            auto target = parent->functions.find(code.get_target(i));
+            if (target != parent->functions.end()) {
+                target->second.do_register_analysis(status);
+            }
         }
         // Otherwise, get instruction analyzer and call it
         else {
@@ -75,7 +103,11 @@ void Function::do_register_analysis(Analyzer* status)
             break;
         }
         if (code.is_branch_unconditional() && !code.is_call()) {
-            block = blocks[block.branch_a];
+            it = blocks.find(block.branch_a);
+            if (it == blocks.end()) {
+                break;
+            }
+            block = it->second;
             i = block.address;
         }
     }
@@ -95,7 +127,8 @@ bool Function::analyze_cfg()
     // Control Flow Graph generation
     while (!labels.empty()) {
         u32 addr = labels.front();
-        code.instruction = nucleus.memory.read32(addr);
+        labels.pop();
+        code = parent->getInstruction(addr);
 
         // Initial Block properties
         current.address = addr;
@@ -103,14 +136,12 @@ bool Function::analyze_cfg()
         current.branch_a = 0;
         current.branch_b = 0;
 
-        u32 maxSize = 0xFFFFFFFF;
-        bool continueLoop = false;
-        for (auto& item : blocks) {
-            Block& block_a = item.second;
-            // Determine maximum possible size for the current block
-            if ((block_a.address - current.address) < maxSize) {
-                maxSize = block_a.address - current.address;
-            }
+        // The block containing the label, if any, is the last one starting at or before it,
+        // and the first one starting after it determines the maximum possible size for the current block
+        auto next = blocks.upper_bound(addr);
+        if (next != blocks.begin()) {
+            Block& block_a = std::prev(next)->second;
+
             // Split block if label (Block B) is inside an existing block (Block A)
             if (block_a.contains(addr)) {
                 // Configure Block B
@@ -119,26 +150,24 @@ bool Function::analyze_cfg()
                 block_b.size = block_a.size - (addr - block_a.address);
                 block_b.branch_a = block_a.branch_a;
                 block_b.branch_b = block_a.branch_b;
+                block_b.branch_table = std::move(block_a.branch_table);
 
                 // Update Block A and push Block B
                 block_a.size = addr - block_a.address;
                 block_a.branch_a = addr;
                 block_a.branch_b = 0;
+                block_a.branch_table.clear();
                 blocks[addr] = block_b;
-                continueLoop = true;
-                break;
+                continue;
             }
         }
-        if (continueLoop) {
-            labels.pop();
-            continue;
-        }
+        const u32 maxSize = (next != blocks.end()) ? (next->first - addr) : 0xFFFFFFFF;
 
         // Wait for the end
         while ((!code.is_branch() || code.is_call()) && (current.size < maxSize)) {
             addr += 4;
             current.size += 4;
-            code.instruction = nucleus.memory.read32(addr);
+            code = parent->getInstruction(addr);
         }
 
         // Push new labels
@@ -161,10 +190,23 @@ bool Function::analyze_cfg()
             labels.push(target);
             current.branch_a = target;
         }
+        current.branch_table.clear();
+        auto table = parent->jumpTables.find(addr);
+        if (table != parent->jumpTables.end()) {
+            for (u32 target : table->second) {
+                labels.push(target);
+            }
+            current.branch_table = table->second;
+        }
 
-        blocks[labels.front()] = current;
-        labels.pop();
+        blocks[current.address] = current;
     }
+
+    size = 0;
+    for (const auto& item : blocks) {
+        size += item.second.size;
+    }
+    return true;
 }
 
 void Function::analyze_type()
@@ -208,71 +250,82 @@ void Function::analyze_type()
     }
 }
 
-llvm::Function* Function::declare()
+llvm::FunctionType* Function::getType(llvm::LLVMContext& context) const
 {
     // Return type
     llvm::Type* result = nullptr;
     switch (type_out) {
     case FUNCTION_OUT_INTEGER:
-        result = llvm::Type::getInt64Ty(llvm::getGlobalContext());
+        result = llvm::Type::getInt64Ty(context);
         break;
     case FUNCTION_OUT_FLOAT:
-        result = llvm::Type::getDoubleTy(llvm::getGlobalContext());
-        break;
-    case FUNCTION_OUT_FLOAT_X2:
-        result = llvm::Type::getDoubleTy(llvm::getGlobalContext()); // TODO
-        break;
+    case FUNCTION_OUT_FLOAT_X2:  // Results on f2:f4 are passed through the thread state
     case FUNCTION_OUT_FLOAT_X3:
-        result = llvm::Type::getDoubleTy(llvm::getGlobalContext()); // TODO
-        break;
     case FUNCTION_OUT_FLOAT_X4:
-        result = llvm::Type::getDoubleTy(llvm::getGlobalContext()); // TODO
+        result = llvm::Type::getDoubleTy(context);
         break;
     case FUNCTION_OUT_VECTOR:
-        result = llvm::Type::getIntNTy(llvm::getGlobalContext(), 128);
+        result = llvm::Type::getIntNTy(context, 128);
         break;
     case FUNCTION_OUT_VOID:
-        result = llvm::Type::getVoidTy(llvm::getGlobalContext());
+        result = llvm::Type::getVoidTy(context);
         break;
     }
 
     // Arguments type
     std::vector<llvm::Type*> params;
+    params.push_back(llvm::Type::getInt8PtrTy(context));  // State
+    params.push_back(llvm::Type::getInt8PtrTy(context));  // Memory base
     for (auto& type : type_in) {
         switch (type) {
         case FUNCTION_OUT_INTEGER:
-            params.push_back(llvm::Type::getInt64Ty(llvm::getGlobalContext()));
+            params.push_back(llvm::Type::getInt64Ty(context));
             break;
         case FUNCTION_OUT_FLOAT:
-            params.push_back(llvm::Type::getDoubleTy(llvm::getGlobalContext()));
+            params.push_back(llvm::Type::getDoubleTy(context));
             break;
         case FUNCTION_OUT_VECTOR:
-            params.push_back(llvm::Type::getIntNTy(llvm::getGlobalContext(), 128));
+            params.push_back(llvm::Type::getIntNTy(context, 128));
             break;
         }
     }
 
-    llvm::FunctionType* ftype = llvm::FunctionType::get(result, params, false);
+    return llvm::FunctionType::get(result, params, false);
+}
 
+llvm::Function* Function::declare(Partition& partition)
+{
     // Declare function in module
-    function = llvm::Function::Create(ftype, llvm::Function::ExternalLinkage, name, parent->module);
+    llvm::FunctionType* ftype = getType(*partition.context);
+    function = llvm::Function::Create(ftype, llvm::Function::ExternalLinkage, name, partition.module);
+    function->setCallingConv(FUNCTION_CALLING_CONV);
+
+    // Declare entry point, with the native signature of cpu::ppu::EntryPoint
+    llvm::LLVMContext& context = *partition.context;
+    llvm::FunctionType* entryType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), std::vector<llvm::Type*>{
+        llvm::Type::getInt8PtrTy(context), llvm::Type::getInt64PtrTy(context), llvm::Type::getDoublePtrTy(context)}, false);
+    entry = llvm::Function::Create(entryType, llvm::Function::ExternalLinkage, name + "_entry", partition.module);
     return function;
 }
 
-llvm::Function* Function::recompile()
+llvm::Function* Function::recompile(Partition& partition)
 {
-    Recompiler recompiler(parent, this);
+    Recompiler recompiler(parent, &partition, this);
     recompiler.returnType = type_out;
 
     std::queue<u32> labels({ address });
 
     // Create LLVM basic blocks
-    prolog = llvm::BasicBlock::Create(llvm::getGlobalContext(), "prolog", function);
+    prolog = llvm::BasicBlock::Create(*partition.context, "prolog", function);
+    u32 index = 0;
     for (auto& item : blocks) {
         Block& block = item.second;
         const std::string name = format("block_%X", block.address);
-        block.bb = llvm::BasicBlock::Create(llvm::getGlobalContext(), name, function);
+        block.bb = llvm::BasicBlock::Create(*partition.context, name, function);
+        block.index = index++;
+        block.recompiled = false;
     }
+    analyzeFlagLiveness(*this);
     recompiler.createProlog();
 
     // Recompile basic clocks
@@ -285,11 +338,28 @@ llvm::Function* Function::recompile()
 
         // Recompile block instructions
         recompiler.setInsertPoint(block.bb);
+        if (!counters.empty()) {
+            recompiler.createBlockCounter(&counters[2 * block.index]);
+        }
+        const std::vector<FlagSet> liveFlags = getLiveFlags(block);
         for (u32 offset = 0; offset < block.size; offset += 4) {
             recompiler.currentAddress = block.address + offset;
+            recompiler.liveFlags = liveFlags[offset / 4];
             const Instruction code = { nucleus.memory.read32(recompiler.currentAddress) };
+
+            const size_t interpreterCalls = recompiler.getInterpreterCallCount();
             auto method = get_entry(code).recompile;
             (recompiler.*method)(code);
+
+            // Instructions executed by the interpreter always update their flags, and only the
+            // flags whose updates are emitted by the recompiler can be eliminated
+            const FlagSet written = code.is_call() ? FLAG_NONE : getFlagEffects(code).write & Recompiler::EMITTED_FLAGS;
+            if (written && recompiler.getInterpreterCallCount() == interpreterCalls) {
+                partition.flagUpdates++;
+                if (!(written & recompiler.liveFlags)) {
+                    partition.flagUpdatesEliminated++;
+                }
+            }
         }
 
         // Block was splitted
@@ -298,7 +368,6 @@ llvm::Function* Function::recompile()
             if (blocks.find(target) != blocks.end()) {
                 recompiler.createBranch(blocks[target]);
             }
-            // Required for .sceStub.text (single-block functions ending on bctr)
             else {
                 recompiler.createReturn();
             }
@@ -311,129 +380,704 @@ llvm::Function* Function::recompile()
         if (block.branch_b) {
             labels.push(block.branch_b);
         }
+        for (u32 target : block.branch_table) {
+            labels.push(target);
+        }
         labels.pop();
     }
 
+    recompiler.createStateSync();
+    recompiler.createArgumentAttributes();
+    recompiler.createEntry();
+
     // Validate the generated code, checking for consistency (TODO: Remove this once the recompiler is stable)
     llvm::verifyFunction(*function, &llvm::outs());
+    llvm::verifyFunction(*entry, &llvm::outs());
     return function;
 }
 
 /**
  * PPU Segment methods
  */
+// Run a task for each index in [0, count) on the worker threads
+static void parallelFor(u32 count, const std::function<void(u32)>& task)
+{
+    u32 workers = std::max(config.ppuCompilerThreads, 0);
+    if (!workers) {
+        workers = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    workers = std::min(workers, count);
+
+    // Workers take the next index until all of them are done
+    std::atomic<u32> next(0);
+    auto worker = [&]() {
+        for (u32 index = next++; index < count; index = next++) {
+            task(index);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (u32 i = 1; i < workers; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 void Segment::analyze()
 {
-    // Lists of labels
-    std::set<u32> labelBlocks;  // Detected immediately
-    std::set<u32> labelCalls;   // Direct target of a {bl*, bcl*} instruction (call)
-    std::set<u32> labelJumps;   // Direct or indirect target of a {b, ba, bc, bca} instruction (jump)
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    // Labels of each instruction of the segment
+    enum : u8 {
+        LABEL_BLOCK = (1 << 0),  // Detected immediately
+        LABEL_CALL  = (1 << 1),  // Direct target of a {bl*, bcl*} instruction (call)
+        LABEL_JUMP  = (1 << 2),  // Direct or indirect target of a {b, ba, bc, bca} instruction (jump)
+    };
+    const u32 count = size / 4;
+    std::vector<u8> labels(count, 0);
+    auto label = [&](u32 addr, u8 type) {
+        if (contains(addr)) {
+            labels[(addr - address) / 4] |= type;
+        }
+    };
 
-    // Basic Block Slicing
+    // Predecoding and Basic Block Slicing in a single pass
+    instructions.resize(count);
+    const u32* words = nucleus.memory.ptr<u32>(address);
+    std::vector<u32> indirectJumps;
     u32 currentBlock = 0;
-    for (u32 i = address; i < (address + size); i += 4) {
-        const Instruction code = { nucleus.memory.read32(i) };
+    for (u32 n = 0; n < count; n++) {
+        const u32 i = address + n * 4;
+        const Instruction code = { re32(words[n]) };
+        instructions[n] = code;
 
         // New block appeared
-        if (code.is_valid() && currentBlock == 0) {
+        const bool valid = code.is_valid();
+        if (valid && currentBlock == 0) {
             currentBlock = i;
         }
 
         // Block is corrupt
-        if (currentBlock != 0 && !code.is_valid()) {
+        if (currentBlock != 0 && !valid) {
             currentBlock = 0;
         }
 
         // Function call detected
         if (currentBlock != 0 && code.is_call()) {
-            labelCalls.insert(code.get_target(i));
+            label(code.get_target(i), LABEL_CALL);
         }
 
         // Block finished
         if (currentBlock != 0 && code.is_branch() && !code.is_call()) {
             if (code.is_branch_conditional()) {
-                labelJumps.insert(code.get_target(i));
-                labelJumps.insert(i + 4);
+                label(code.get_target(i), LABEL_JUMP);
+                label(i + 4, LABEL_JUMP);
             }
             if (code.is_branch_unconditional()) {
-                labelJumps.insert(code.get_target(i));
+                label(code.get_target(i), LABEL_JUMP);
+            }
+            if (code.opcode == 0x13 && code.op19 == 0x210) {
+                indirectJumps.push_back(i);
             }
-            labelBlocks.insert(currentBlock);
+            label(currentBlock, LABEL_BLOCK);
             currentBlock = 0;
         }
     }
 
-    // Functions := ((Blocks \ Jumps) U Calls)
-    std::set<u32> labelFunctions;
-    std::set_difference(labelBlocks.begin(), labelBlocks.end(), labelJumps.begin(), labelJumps.end(), std::inserter(labelFunctions, labelFunctions.end()));
-    std::set_union(labelFunctions.begin(), labelFunctions.end(), labelCalls.begin(), labelCalls.end(), std::inserter(labelFunctions, labelFunctions.end()));
-
-    // List the functions and get their CFG
-    for (const auto& label : labelFunctions) {
-        if (this->contains(label)) {
-            Function function(label, this);
-            if (function.analyze_cfg()) {
-                functions[label] = function;
+    // Recover the jump tables of indirect jumps, whose targets belong to the function containing them
+    for (u32 addr : indirectJumps) {
+        std::vector<u32> targets;
+        if (findJumpTable(*this, addr, targets)) {
+            for (u32 target : targets) {
+                label(target, LABEL_JUMP);
             }
+            jumpTables[addr] = std::move(targets);
+        }
+    }
+
+    // Functions := ((Blocks \ Jumps) U Calls)
+    std::vector<Function*> candidates;
+    for (u32 n = 0; n < count; n++) {
+        const u8 type = labels[n];
+        if (((type & LABEL_BLOCK) && !(type & LABEL_JUMP)) || (type & LABEL_CALL)) {
+            const u32 addr = address + n * 4;
+            Function& function = functions[addr];
+            function = Function(addr, this);
+            candidates.push_back(&function);
+        }
+    }
+
+    // Get the CFG of every function, discarding the ones branching outside the segment
+    std::vector<u8> valid(candidates.size());
+    parallelFor(candidates.size(), [&](u32 index) {
+        valid[index] = candidates[index]->analyze_cfg();
+    });
+    for (u32 index = 0; index < candidates.size(); index++) {
+        if (!valid[index]) {
+            functions.erase(candidates[index]->address);
         }
     }
+
     // Get type of every listed function
+    candidates.clear();
     for (auto& item : functions) {
-        Function& function = item.second;
-        function.analyze_type();
+        candidates.push_back(&item.second);
+    }
+    parallelFor(candidates.size(), [&](u32 index) {
+        candidates[index]->analyze_type();
+    });
+
+    // Calls to import stubs are linked to the imported functions once their modules are loaded
+    findImportStubs();
+
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    nucleus.log.notice(LOG_CPU, "Analyzed %d functions of %s in %.3f s (%.0f functions/s)",
+        functions.size(), name.c_str(), elapsed.count(), functions.size() / std::max(elapsed.count(), 1e-9));
+    if (!indirectJumps.empty()) {
+        nucleus.log.notice(LOG_CPU, "Resolved %d of %d indirect jumps (bctr) of %s through jump tables (%.1f%%)",
+            jumpTables.size(), indirectJumps.size(), name.c_str(), 100.0 * jumpTables.size() / indirectJumps.size());
+    }
+    if (!importStubs.empty()) {
+        nucleus.log.notice(LOG_CPU, "Found %d import stubs in %s", importStubs.size(), name.c_str());
+    }
+}
+
+Segment::~Segment()
+{
+    if (!partitions.empty()) {
+        nucleus.cell.ppu_dispatch.clear(address, size);
+    }
+
+    // The execution engines own the modules, which must be deleted before their contexts
+    for (auto& partition : partitions) {
+        delete partition.executionEngine;
+        delete partition.context;
     }
 }
 
 void Segment::recompile()
 {
-    module = new llvm::Module(name, llvm::getGlobalContext());
+    const auto start = std::chrono::high_resolution_clock::now();
+    cacheKey = ObjectCache::getKey(address, size);
 
-    // Optimization passes
-    fpm = new llvm::FunctionPassManager(module);
-    fpm->add(llvm::createPromoteMemoryToRegisterPass());  // Promote allocas to registers
-    fpm->add(llvm::createInstructionCombiningPass());     // Simple peephole and bit-twiddling optimizations
-    fpm->add(llvm::createReassociatePass());              // Reassociate expressions
-    fpm->add(llvm::createGVNPass());                      // Eliminate Common SubExpressions
-    fpm->add(llvm::createCFGSimplificationPass());        // Simplify the Control Flow Graph (e.g.: deleting unreachable blocks)
-    fpm->doInitialization();
+    // Using more partitions than workers balances the load, since their sizes are only estimated
+    u32 workers = std::max(config.ppuCompilerThreads, 0);
+    if (!workers) {
+        workers = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    createPartitions(workers * 4);
+    workers = std::min<u32>(workers, partitions.size());
+    parallelFor(partitions.size(), [&](u32 index) {
+        recompilePartition(index);
+    });
 
-    // Global variables
-    module->getOrInsertGlobal("memoryBase", llvm::Type::getInt64Ty(llvm::getGlobalContext()));
-    memoryBase = module->getNamedGlobal("memoryBase");
-    module->getOrInsertGlobal("ppuState", State::type());
-    ppuState = module->getNamedGlobal("ppuState");
-    ppuState->setThreadLocal(true);
+    linkPartitions();
+    save();
 
-    // Declare all functions
-    for (auto& item : functions) {
-        Function& function = item.second;
-        function.declare();
+    // Compile-time report
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    double totalTime = 0.0;
+    double longestTime = 0.0;
+    for (const auto& partition : partitions) {
+        totalTime += partition.compileTime;
+        longestTime = std::max(longestTime, partition.compileTime);
     }
+    nucleus.log.notice(LOG_CPU, "Recompiled %d functions of %s in %.3f s (%d partitions on %d threads, %.3f s of work, longest partition %.3f s)",
+        functions.size(), name.c_str(), elapsed.count(), partitions.size(), workers, totalTime, longestTime);
 
-    // Recompile and optimize all functions
+    // Flag liveness report
+    u32 flagUpdates = 0;
+    u32 flagUpdatesEliminated = 0;
+    for (const auto& partition : partitions) {
+        flagUpdates += partition.flagUpdates;
+        flagUpdatesEliminated += partition.flagUpdatesEliminated;
+    }
+    if (flagUpdates) {
+        nucleus.log.notice(LOG_CPU, "Eliminated %d of %d flag updates in %s (%.1f%%)",
+            flagUpdatesEliminated, flagUpdates, name.c_str(), 100.0 * flagUpdatesEliminated / flagUpdates);
+    }
+}
+
+bool Segment::recompileFunction(u32 addr)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    // Find the function containing the address
+    auto it = functions.upper_bound(addr);
+    if (it == functions.begin()) {
+        return false;
+    }
+    Function& hotFunction = (--it)->second;
+    auto block = hotFunction.blocks.upper_bound(addr);
+    if (block == hotFunction.blocks.begin() || !(--block)->second.contains(addr)) {
+        return false;
+    }
+    if (hotFunction.function) {
+        return false;
+    }
+
+    // Every function gets an entry in the function table, filled as they are recompiled
+    if (functionTable.empty()) {
+        u32 index = 0;
+        for (auto& item : functions) {
+            item.second.index = index++;
+        }
+        functionTable.assign(functions.size(), 0);
+    }
+
+    // Callees are recompiled in the same partition, so recompiled code only calls recompiled functions
+    partitions.emplace_back();
+    const u32 index = partitions.size() - 1;
+    Partition& partition = partitions.back();
+    partition.profiled = true;
+    std::set<u32> queued({ hotFunction.address });
+    std::vector<u32> pending({ hotFunction.address });
+    while (!pending.empty()) {
+        Function& function = functions.at(pending.back());
+        pending.pop_back();
+        function.partition = index;
+        function.tier = 1;
+        function.counters.assign(2 * function.blocks.size(), 0);
+        partition.functions.push_back(function.address);
+        partition.size += function.size;
+
+        for (const auto& item : function.blocks) {
+            const Block& block = item.second;
+            for (u32 i = block.address; i < (block.address + block.size); i += 4) {
+                const Instruction code = getInstruction(i);
+                if (!code.is_call_known()) {
+                    continue;
+                }
+                auto target = functions.find(code.get_target(i));
+                if (target != functions.end() && !target->second.function && queued.insert(target->first).second) {
+                    pending.push_back(target->first);
+                }
+            }
+        }
+    }
+
+    recompilePartition(index);
+    linkPartition(index);
+
+    // Import stubs of every module calling the new code are linked to it
+    nucleus.cell.linkImports();
+
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    nucleus.log.notice(LOG_CPU, "Recompiled hot function %s along with %d callees in %.3f s",
+        hotFunction.name.c_str(), partition.functions.size() - 1, elapsed.count());
+    return true;
+}
+
+bool Segment::optimizeFunction(u32 addr)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    auto it = functions.find(addr);
+    if (it == functions.end() || it->second.tier != 1) {
+        return false;
+    }
+    Function& hotFunction = it->second;
+
+    // Callees from executed blocks are recompiled in the same partition, so they can be inlined
+    partitions.emplace_back();
+    const u32 index = partitions.size() - 1;
+    Partition& partition = partitions.back();
+    partition.optimized = true;
+    partition.functions.push_back(hotFunction.address);
+    for (const auto& item : hotFunction.blocks) {
+        const Block& block = item.second;
+        if (!hotFunction.counters[2 * block.index]) {
+            continue;
+        }
+        for (u32 i = block.address; i < (block.address + block.size); i += 4) {
+            const Instruction code = getInstruction(i);
+            if (!code.is_call_known()) {
+                continue;
+            }
+            auto target = functions.find(code.get_target(i));
+            if (target != functions.end() && target->second.tier != 0 &&
+                std::find(partition.functions.begin(), partition.functions.end(), target->first) == partition.functions.end()) {
+                partition.functions.push_back(target->first);
+            }
+        }
+    }
+    for (u32 function : partition.functions) {
+        functions.at(function).partition = index;
+        functions.at(function).tier = 2;
+        partition.size += functions.at(function).size;
+    }
+
+    recompilePartition(index);
+    linkPartition(index);
+
+    // Import stubs of every module calling the new code are linked to it
+    nucleus.cell.linkImports();
+
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    nucleus.log.notice(LOG_CPU, "Optimized hot function %s along with %d callees in %.3f s",
+        hotFunction.name.c_str(), partition.functions.size() - 1, elapsed.count());
+    return true;
+}
+
+bool Segment::load()
+{
+    ObjectCache& cache = nucleus.cell.ppu_cache;
+    if (!cache.isEnabled()) {
+        return false;
+    }
+
+    // Both the function list and the objects of all partitions are required
+    cacheKey = ObjectCache::getKey(address, size);
+    std::string data;
+    if (!cache.load(getModuleName(0) + ".func", data)) {
+        return false;
+    }
+
+    // Parse function list
+    size_t offset = 0;
+    auto read = [&](void* dst, size_t size) -> bool {
+        if (offset + size > data.size()) {
+            return false;
+        }
+        memcpy(dst, &data[offset], size);
+        offset += size;
+        return true;
+    };
+    u32 partitionCount = 0;
+    u32 count = 0;
+    bool valid = read(&partitionCount, sizeof(u32)) && read(&count, sizeof(u32)) && partitionCount > 0;
+    partitions.resize(valid ? partitionCount : 0);
+    for (u32 i = 0; valid && i < count; i++) {
+        u32 addr = 0;
+        u32 partition = 0;
+        u8 typeOut = 0;
+        u8 typeInCount = 0;
+        u8 typeIn[0x100];
+        u16 nameLength = 0;
+        valid = read(&addr, sizeof(u32)) && read(&partition, sizeof(u32)) && partition < partitionCount &&
+            read(&typeOut, sizeof(u8)) && read(&typeInCount, sizeof(u8)) && read(typeIn, typeInCount) &&
+            read(&nameLength, sizeof(u16));
+
+        Function function(addr, this);
+        function.partition = partition;
+        function.index = i;
+        function.type_out = (FunctionTypeOut)typeOut;
+        for (u8 j = 0; valid && j < typeInCount; j++) {
+            function.type_in.push_back((FunctionTypeIn)typeIn[j]);
+        }
+        function.name.resize(nameLength);
+        valid = valid && (nameLength == 0 || read(&function.name[0], nameLength));
+        if (valid) {
+            functions[addr] = function;
+            partitions[partition].functions.push_back(addr);
+        }
+    }
+    for (u32 i = 0; valid && i < partitionCount; i++) {
+        valid = cache.preload(getModuleName(i));
+    }
+    if (!valid) {
+        functions.clear();
+        partitions.clear();
+        return false;
+    }
+
+    // Declare all functions and link the cached objects
+    // NOTE: Import stubs are found again, since the cached code expects their links in the same order
+    findImportStubs();
+    functionTable.assign(functions.size(), 0);
+    for (u32 i = 0; i < partitionCount; i++) {
+        partitions[i].context = new llvm::LLVMContext();
+        declarePartition(i);
+        createExecutionEngine(i);
+    }
+    linkPartitions();
+
+    nucleus.log.notice(LOG_CPU, "Loaded %d functions of %s from the PPU cache", functions.size(), name.c_str());
+    return true;
+}
+
+void Segment::save()
+{
+    ObjectCache& cache = nucleus.cell.ppu_cache;
+    if (!cache.isEnabled()) {
+        return;
+    }
+
+    std::string data;
+    auto write = [&](const void* src, size_t size) {
+        data.append((const char*)src, size);
+    };
+    const u32 partitionCount = partitions.size();
+    const u32 count = functions.size();
+    write(&partitionCount, sizeof(u32));
+    write(&count, sizeof(u32));
+    for (const auto& item : functions) {
+        const Function& function = item.second;
+        const u8 typeOut = function.type_out;
+        const u8 typeInCount = function.type_in.size();
+        const u16 nameLength = function.name.size();
+        write(&function.address, sizeof(u32));
+        write(&function.partition, sizeof(u32));
+        write(&typeOut, sizeof(u8));
+        write(&typeInCount, sizeof(u8));
+        for (const auto& type : function.type_in) {
+            const u8 typeIn = type;
+            write(&typeIn, sizeof(u8));
+        }
+        write(&nameLength, sizeof(u16));
+        write(function.name.data(), nameLength);
+    }
+    cache.save(getModuleName(0) + ".func", data);
+}
+
+void Segment::findImportStubs()
+{
+    std::vector<u32> slots;
+    importStubs.clear();
+    for (const auto& item : functions) {
+        u32 slot = 0;
+        if (findImportStub(*this, item.first, slot)) {
+            importStubs[item.first] = slots.size();
+            slots.push_back(slot);
+        }
+    }
+    importLinks.reset(new ImportLink[slots.size()]());
+    for (u32 i = 0; i < slots.size(); i++) {
+        importLinks[i].slot = slots[i];
+    }
+}
+
+void Segment::linkImports()
+{
+    auto& memory = nucleus.memory(SEG_MAIN_MEMORY);
+    for (u32 i = 0; i < importStubs.size(); i++) {
+        ImportLink& link = importLinks[i];
+
+        // Import table entries hold the address of the descriptor of the imported function: Entry address and TOC base
+        EntryPoint entry = nullptr;
+        u32 toc = 0;
+        const u32 descriptor = memory.isValid(link.slot) ? nucleus.memory.read32(link.slot) : 0;
+        if (descriptor && memory.isValid(descriptor) && memory.isValid(descriptor + 7)) {
+            entry = nucleus.cell.ppu_dispatch.find(nucleus.memory.read32(descriptor));
+            toc = nucleus.memory.read32(descriptor + 4);
+        }
+        if (entry == link.entry.load(std::memory_order_relaxed) && (!entry || toc == link.toc)) {
+            continue;
+        }
+
+        // Calls go through the stub while the link is updated
+        link.entry.store(nullptr, std::memory_order_release);
+        if (entry) {
+            link.toc = toc;
+            link.entry.store(entry, std::memory_order_release);
+        }
+    }
+}
+
+std::string Segment::getModuleName(u32 partition) const
+{
+    return format("%s_%016llX_%d", name.c_str(), cacheKey, partition);
+}
+
+void Segment::createPartitions(u32 count)
+{
+    u32 totalSize = 0;
+    for (const auto& item : functions) {
+        totalSize += item.second.size;
+    }
+    count = std::max(std::min<u32>(count, functions.size()), 1U);
+    const u32 partitionSize = totalSize / count + 1;
+
+    // Consecutive functions are likely to call each other, keeping most calls inside the same partition
+    partitions.clear();
+    partitions.resize(count);
+    u32 current = 0;
+    u32 index = 0;
     for (auto& item : functions) {
         Function& function = item.second;
-        llvm::Function* func = function.recompile();
-        fpm->run(*func);
+        if (partitions[current].size >= partitionSize && current + 1 < count) {
+            current += 1;
+        }
+        function.partition = current;
+        function.index = index++;
+        partitions[current].functions.push_back(function.address);
+        partitions[current].size += function.size;
+    }
+    partitions.resize(current + 1);
+    functionTable.assign(functions.size(), 0);
+}
+
+void Segment::declarePartition(u32 index)
+{
+    Partition& partition = partitions[index];
+    llvm::LLVMContext& context = *partition.context;
+    llvm::Module* module = new llvm::Module(getModuleName(index), context);
+    partition.module = module;
+
+    // Global variables
+    module->getOrInsertGlobal("memoryBase", llvm::Type::getInt64Ty(context));
+    partition.memoryBase = module->getNamedGlobal("memoryBase");
+    module->getOrInsertGlobal("functionTable", llvm::ArrayType::get(llvm::Type::getInt64Ty(context), functionTable.size()));
+    partition.functionTable = module->getNamedGlobal("functionTable");
+    if (!importStubs.empty()) {
+        llvm::Type* i64 = llvm::Type::getInt64Ty(context);
+        llvm::Type* i32 = llvm::Type::getInt32Ty(context);
+        llvm::StructType* linkType = llvm::StructType::get(context, std::vector<llvm::Type*>{ i64, i32, i32 });
+        module->getOrInsertGlobal("importLinks", llvm::ArrayType::get(linkType, importStubs.size()));
+        partition.importLinks = module->getNamedGlobal("importLinks");
+    }
+
+    // Runtime functions
+    llvm::Type* i32 = llvm::Type::getInt32Ty(context);
+    llvm::FunctionType* spinType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), std::vector<llvm::Type*>{i32, i32}, false);
+    llvm::Function::Create(spinType, llvm::Function::ExternalLinkage, "ppuSpinWait", module);
+    llvm::FunctionType* dispatchType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), std::vector<llvm::Type*>{
+        llvm::Type::getInt8PtrTy(context), i32, llvm::Type::getInt64PtrTy(context), llvm::Type::getDoublePtrTy(context)}, false);
+    llvm::Function::Create(dispatchType, llvm::Function::ExternalLinkage, "ppuDispatch", module);
+    llvm::FunctionType* indirectCallType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), std::vector<llvm::Type*>{
+        llvm::Type::getInt8PtrTy(context), llvm::Type::getInt8PtrTy(context), i32, llvm::Type::getInt64PtrTy(context), llvm::Type::getDoublePtrTy(context)}, false);
+    llvm::Function::Create(indirectCallType, llvm::Function::ExternalLinkage, "ppuIndirectCall", module);
+    llvm::FunctionType* interpretType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), std::vector<llvm::Type*>{i32}, false);
+    llvm::Function::Create(interpretType, llvm::Function::ExternalLinkage, "ppuInterpretInstruction", module);
+    llvm::Function::Create(interpretType, llvm::Function::ExternalLinkage, "ppuInterpretFrom", module);
+    llvm::FunctionType* tierUpType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), std::vector<llvm::Type*>{i32}, false);
+    llvm::Function::Create(tierUpType, llvm::Function::ExternalLinkage, "ppuTierUp", module);
+    llvm::Type* i64 = llvm::Type::getInt64Ty(context);
+    llvm::FunctionType* profileEnterType = llvm::FunctionType::get(i64, false);
+    llvm::Function::Create(profileEnterType, llvm::Function::ExternalLinkage, "ppuProfileEnter", module);
+    llvm::FunctionType* profileExitType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), std::vector<llvm::Type*>{i32, i32, i64, i64}, false);
+    llvm::Function::Create(profileExitType, llvm::Function::ExternalLinkage, "ppuProfileExit", module);
+    llvm::Type* i8ptr = llvm::Type::getInt8PtrTy(context);
+    llvm::FunctionType* reservationLoad32Type = llvm::FunctionType::get(i32, std::vector<llvm::Type*>{i8ptr, i32}, false);
+    llvm::Function::Create(reservationLoad32Type, llvm::Function::ExternalLinkage, "reservationLoad32", module);
+    llvm::FunctionType* reservationLoad64Type = llvm::FunctionType::get(i64, std::vector<llvm::Type*>{i8ptr, i32}, false);
+    llvm::Function::Create(reservationLoad64Type, llvm::Function::ExternalLinkage, "reservationLoad64", module);
+    llvm::FunctionType* reservationStore32Type = llvm::FunctionType::get(i32, std::vector<llvm::Type*>{i8ptr, i32, i32}, false);
+    llvm::Function::Create(reservationStore32Type, llvm::Function::ExternalLinkage, "reservationStore32", module);
+    llvm::FunctionType* reservationStore64Type = llvm::FunctionType::get(i32, std::vector<llvm::Type*>{i8ptr, i32, i64}, false);
+    llvm::Function::Create(reservationStore64Type, llvm::Function::ExternalLinkage, "reservationStore64", module);
+
+    // Declare all functions of the partition
+    for (u32 addr : partition.functions) {
+        functions.at(addr).declare(partition);
     }
+}
+
+void Segment::createExecutionEngine(u32 index)
+{
+    Partition& partition = partitions[index];
 
     // NOTE: Avoid generating COFF objects on Windows which are not supported by MCJIT
     llvm::Triple triple(llvm::sys::getProcessTriple());
     if (triple.getOS() == llvm::Triple::OSType::Win32) {
         triple.setObjectFormat(llvm::Triple::ObjectFormatType::ELF);
     }
-    module->setTargetTriple(triple.str());
+    partition.module->setTargetTriple(triple.str());
 
     // Create execution engine
-    llvm::EngineBuilder engineBuilder(module);
+    llvm::EngineBuilder engineBuilder(partition.module);
     engineBuilder.setEngineKind(llvm::EngineKind::JIT);
     engineBuilder.setOptLevel(llvm::CodeGenOpt::Default);
+    engineBuilder.setMCPU(llvm::sys::getHostCPUName());
     engineBuilder.setUseMCJIT(true);
-    executionEngine = engineBuilder.create();
-    executionEngine->addModule(nucleus.cell.module);
+    llvm::ExecutionEngine* executionEngine = engineBuilder.create();
+    partition.executionEngine = executionEngine;
+
+    // Global variables and runtime functions defined by the host
+    const u64 memoryBaseAddr = nucleus.cell.executionEngine->getGlobalValueAddress("memoryBase");
+    executionEngine->addGlobalMapping(partition.memoryBase, (void*)memoryBaseAddr);
+    executionEngine->addGlobalMapping(partition.functionTable, functionTable.data());
+    if (partition.importLinks) {
+        executionEngine->addGlobalMapping(partition.importLinks, importLinks.get());
+    }
+    executionEngine->addGlobalMapping(partition.module->getFunction("ppuSpinWait"), (void*)&ppuSpinWait);
+    executionEngine->addGlobalMapping(partition.module->getFunction("ppuDispatch"), (void*)&ppuDispatch);
+    executionEngine->addGlobalMapping(partition.module->getFunction("ppuIndirectCall"), (void*)&ppuIndirectCall);
+    executionEngine->addGlobalMapping(partition.module->getFunction("ppuInterpretInstruction"), (void*)&ppuInterpretInstruction);
+    executionEngine->addGlobalMapping(partition.module->getFunction("ppuInterpretFrom"), (void*)&ppuInterpretFrom);
+    executionEngine->addGlobalMapping(partition.module->getFunction("ppuTierUp"), (void*)&ppuTierUp);
+    executionEngine->addGlobalMapping(partition.module->getFunction("ppuProfileEnter"), (void*)&ppuProfileEnter);
+    executionEngine->addGlobalMapping(partition.module->getFunction("ppuProfileExit"), (void*)&ppuProfileExit);
+    executionEngine->addGlobalMapping(partition.module->getFunction("reservationLoad32"), (void*)&reservationLoad32);
+    executionEngine->addGlobalMapping(partition.module->getFunction("reservationLoad64"), (void*)&reservationLoad64);
+    executionEngine->addGlobalMapping(partition.module->getFunction("reservationStore32"), (void*)&reservationStore32);
+    executionEngine->addGlobalMapping(partition.module->getFunction("reservationStore64"), (void*)&reservationStore64);
+
+    // Objects are generated, or loaded from the cache, once finalized
+    // NOTE: Partitions of the tiered translator depend on the execution order, so they are not cached
+    if (nucleus.cell.ppu_cache.isEnabled() && config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
+        executionEngine->setObjectCache(&nucleus.cell.ppu_cache);
+    }
     executionEngine->finalizeObject();
 }
 
+void Segment::recompilePartition(u32 index)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    Partition& partition = partitions[index];
+    partition.context = new llvm::LLVMContext();
+    declarePartition(index);
+
+    // Optimization passes
+    llvm::FunctionPassManager fpm(partition.module);
+    fpm.add(llvm::createPromoteMemoryToRegisterPass());  // Promote allocas to registers
+    fpm.add(llvm::createInstructionCombiningPass());     // Simple peephole and bit-twiddling optimizations
+    fpm.add(llvm::createReassociatePass());              // Reassociate expressions
+    fpm.add(llvm::createGVNPass());                      // Eliminate Common SubExpressions
+    fpm.add(llvm::createCFGSimplificationPass());        // Simplify the Control Flow Graph (e.g.: deleting unreachable blocks)
+    fpm.doInitialization();
+
+    // Recompile and optimize all functions
+    for (u32 addr : partition.functions) {
+        llvm::Function* func = functions.at(addr).recompile(partition);
+        fpm.run(*func);
+    }
+    fpm.doFinalization();
+
+    // Profile-guided optimizations: Inline hot callees, optimize loops and vectorize
+    if (partition.optimized) {
+        llvm::PassManager pm;
+        pm.add(llvm::createBasicAliasAnalysisPass());
+        pm.add(llvm::createFunctionInliningPass(OPTIMIZED_INLINE_THRESHOLD));
+        pm.add(llvm::createPromoteMemoryToRegisterPass());
+        pm.add(llvm::createInstructionCombiningPass());
+        pm.add(llvm::createLoopRotatePass());
+        pm.add(llvm::createLICMPass());
+        pm.add(llvm::createIndVarSimplifyPass());
+        pm.add(llvm::createLoopUnrollPass());
+        pm.add(llvm::createSLPVectorizerPass());
+        pm.add(llvm::createInstructionCombiningPass());
+        pm.add(llvm::createGVNPass());
+        pm.add(llvm::createCFGSimplificationPass());
+        pm.run(*partition.module);
+    }
+
+    createExecutionEngine(index);
+
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    partition.compileTime = elapsed.count();
+}
+
+void Segment::linkPartition(u32 index)
+{
+    llvm::ExecutionEngine* executionEngine = partitions[index].executionEngine;
+    for (u32 addr : partitions[index].functions) {
+        const Function& function = functions.at(addr);
+        functionTable[function.index] = executionEngine->getFunctionAddress(function.function->getName().str());
+        const u64 entryAddr = executionEngine->getFunctionAddress(function.entry->getName().str());
+        nucleus.cell.ppu_dispatch.set(function.address, (EntryPoint)entryAddr);
+    }
+}
+
+void Segment::linkPartitions()
+{
+    for (u32 i = 0; i < partitions.size(); i++) {
+        linkPartition(i);
+    }
+}
+
 bool Segment::contains(u32 addr) const
 {
     const u32 from = address;
@@ -441,5 +1085,15 @@ bool Segment::contains(u32 addr) const
     return from <= addr && addr < to;
 }
 
+Instruction Segment::getInstruction(u32 addr) const
+{
+    const u32 index = (addr - address) / 4;
+    if (contains(addr) && index < instructions.size()) {
+        return instructions[index];
+    }
+    const Instruction code = { nucleus.memory.read32(addr) };
+    return code;
+}
+
 }  // namespace ppu
 }  // namespace cpu
@@ -8,12 +8,16 @@
 #include "nucleus/common.h"
 #include "nucleus/format.h"
 #include "analyzer/ppu_analyzer.h"
+#include "analyzer/ppu_analyzer_flags.h"
+#include "nucleus/cpu/ppu/ppu_dispatch.h"
 
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/IR/CallingConv.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
-#include "llvm/PassManager.h"
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -23,6 +27,7 @@ namespace ppu {
 // Class declarations
 class Block;
 class Function;
+class Partition;
 class Segment;
 
 // Function type
@@ -44,6 +49,18 @@ enum FunctionTypeOut {
     FUNCTION_OUT_VOID,        // Nothing is returned
 };
 
+/**
+ * Calling convention:
+ * Recompiled functions receive the state of the current thread and the guest memory base as their
+ * first arguments, followed by the guest arguments, so that none of them is read from globals.
+ * Arguments and results are passed in host registers, and guest registers are only written back
+ * to the thread state before exiting to the runtime.
+ */
+static const llvm::CallingConv::ID FUNCTION_CALLING_CONV = llvm::CallingConv::Fast;
+static const u32 FUNCTION_ARG_STATE = 0;
+static const u32 FUNCTION_ARG_MEMORY_BASE = 1;
+static const u32 FUNCTION_ARG_GUEST = 2;  // First guest argument
+
 class Block
 {
 public:
@@ -51,6 +68,7 @@ public:
 
     u32 address = 0; // Starting address in the EA space
     u32 size = 0;    // Number of bytes covered
+    u32 index = 0;   // Position in the parent function, locating its profile counters
 
     bool initial;                   // Is this a function entry block?
     bool jump_destination = false;  // Is this a target of a bx/bcx instruction?
@@ -60,6 +78,10 @@ public:
     // Branching
     u32 branch_a = 0; // Conditional-True or Unconditional branching address
     u32 branch_b = 0; // Conditional-False branching address
+    std::vector<u32> branch_table; // Targets of the jump table branched to by the final bctr, if recovered
+
+    // Flags (CR fields, XER bits, FPSCR) that might be read after leaving this block
+    FlagSet live_flags_out = FLAG_ALL;
 
     // Determines whether the specified address is part of this block
     bool contains(u32 addr) const;
@@ -77,11 +99,12 @@ class Function
 
 public:
     llvm::Function* function = nullptr;
+    llvm::Function* entry = nullptr;  // Wrapper called through the dispatch table
 
     u32 address = 0; // Starting address in the EA space
     u32 size = 0;    // Number of bytes covered (sum of basic block sizes)
 
-    // Control Flow Graph
+    // Control Flow Graph (blocks are indexed by their starting address and never overlap)
     std::map<u32, Block> blocks;
     llvm::BasicBlock* prolog;
     llvm::BasicBlock* epilog;
@@ -97,28 +120,97 @@ public:
         name = format("func_%X", address);
     }
 
+    // Recompilation
+    u32 partition = 0;  // Partition of the parent segment containing this function
+    u32 index = 0;      // Entry in the function table of the parent segment
+
+    // Tiered translator
+    u8 tier = 0;                // Current code: 0 (Interpreted), 1 (Profiled) or 2 (Optimized with the profile)
+    std::vector<u64> counters;  // Executions of each block followed by the number of times its branch was taken
+    u8 tierUpRequested = 0;     // Set by the profiled code once it requests its optimization
+
     // Analysis
     bool analyze_cfg();  // Generate CFG (and return if branching addresses stay inside the parent segment)
     void analyze_type(); // Determine function arguments/return types
 
-    // Declare function inside the parent segment
-    llvm::Function* declare();
+    // Get the LLVM type of this function: The thread state and the guest memory base are passed
+    // before the guest arguments, and the function uses the calling convention below
+    llvm::FunctionType* getType(llvm::LLVMContext& context) const;
+
+    // Declare function and its entry point inside its partition of the parent segment
+    llvm::Function* declare(Partition& partition);
 
     // Recompile function
-    llvm::Function* recompile();
+    llvm::Function* recompile(Partition& partition);
 };
 
-class Segment
+/**
+ * Segment partition:
+ * Functions of a segment are split in partitions of consecutive functions, each one recompiled,
+ * optimized and compiled to machine code by a worker thread with its own LLVM context, module and
+ * execution engine. Calls between partitions load their target from the function table of the segment,
+ * filled once every partition is finalized.
+ */
+class Partition
 {
-    llvm::FunctionPassManager* fpm = nullptr;
-
 public:
+    llvm::LLVMContext* context = nullptr;
     llvm::Module* module = nullptr;
     llvm::ExecutionEngine* executionEngine = nullptr;
 
     // Global variables
-    llvm::GlobalVariable* memoryBase;
-    llvm::GlobalVariable* ppuState;
+    llvm::GlobalVariable* memoryBase = nullptr;  // Only read by entry points
+    llvm::GlobalVariable* functionTable = nullptr;
+    llvm::GlobalVariable* importLinks = nullptr;  // Only declared if the segment has import stubs
+
+    // Addresses of the functions contained
+    std::vector<u32> functions;
+    u32 size = 0;
+
+    // Time spent recompiling and compiling this partition (in seconds)
+    double compileTime = 0.0;
+
+    // Recompiled instructions updating flags, and those whose updates were skipped since the flags are dead
+    u32 flagUpdates = 0;
+    u32 flagUpdatesEliminated = 0;
+
+    // Tiered translator
+    bool profiled = false;   // Functions count the executions of their blocks and branches
+    bool optimized = false;  // Functions are optimized using the profile collected by their previous code
+};
+
+class Segment
+{
+    // Hash of the segment contents and recompiler version
+    u64 cacheKey = 0;
+
+    // Name of the module of a partition, identifying its contents in the recompiled code cache
+    std::string getModuleName(u32 partition) const;
+
+    // Find the import stubs among the functions, allocating their links
+    void findImportStubs();
+
+    // Split the functions in partitions of similar size
+    void createPartitions(u32 count);
+
+    // Create the module of a partition declaring its functions, global variables and runtime functions
+    void declarePartition(u32 index);
+
+    // Generate or load the code of a partition and link it
+    void createExecutionEngine(u32 index);
+
+    // Recompile the functions of a partition, called from worker threads
+    void recompilePartition(u32 index);
+
+    // Fill the function table and the dispatch table with the functions of a partition once it is linked
+    void linkPartition(u32 index);
+    void linkPartitions();
+
+public:
+    std::vector<Partition> partitions;
+
+    // Host address of each function, indexed by Function::index
+    std::vector<u64> functionTable;
 
     u32 address = 0; // Starting address in the EA space
     u32 size = 0;    // Number of bytes covered
@@ -126,16 +218,26 @@ public:
     // Functions contained
     std::map<u32, Function> functions;
 
+    // Instructions of the segment in host endianness, predecoded by the analyzer
+    std::vector<Instruction> instructions;
+
+    // Value of r2 in the functions of this segment (TOC base), or 0 if unknown
+    u32 toc = 0;
+
+    // Targets of the jump tables recovered by the analyzer, indexed by the address of their bctr
+    std::map<u32, std::vector<u32>> jumpTables;
+
+    // Index of the link of each import stub, indexed by the address of the stub
+    std::map<u32, u32> importStubs;
+    std::unique_ptr<ImportLink[]> importLinks;
+
     std::string name;
 
-    Segment(u32 address, u32 size) : address(address), size(size) {
+    Segment(u32 address, u32 size, u32 toc=0) : address(address), size(size), toc(toc) {
         name = format("seg_%X", address);
     }
 
-    ~Segment() {
-        // The execution engines owns the module, which will be deleted
-        delete executionEngine;
-    }
+    ~Segment();
 
     // Generate a list of functions and analyze them
     void analyze();
@@ -143,8 +245,28 @@ public:
     // Recompile each of the functions
     void recompile();
 
+    // Recompile the function containing the address along with the functions it calls not recompiled yet,
+    // returning false if there is no such function or it was already recompiled (used by the tiered translator)
+    bool recompileFunction(u32 addr);
+
+    // Recompile a profiled function along with its executed callees using the collected profile,
+    // returning false if there is no such function or it is not profiled (used by the tiered translator)
+    bool optimizeFunction(u32 addr);
+
+    // Load the functions and their recompiled code from the cache, skipping analysis and recompilation
+    bool load();
+
+    // Store the functions in the cache (their code is stored by MCJIT)
+    void save();
+
+    // Link the calls to the import stubs to the current code of the functions referenced by the import table
+    void linkImports();
+
     // Determines whether the specified address is part of this segment
     bool contains(u32 addr) const;
+
+    // Get the instruction at the specified address, predecoded if it is part of this segment
+    Instruction getInstruction(u32 addr) const;
 };
 
 }  // namespace ppu
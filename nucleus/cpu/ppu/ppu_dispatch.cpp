@@ -0,0 +1,76 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_dispatch.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_thread.h"
+
+namespace cpu {
+namespace ppu {
+
+std::atomic<u64> g_inlineCacheMisses(0);
+
+void InlineCache::insert(u32 target, std::atomic<EntryPoint>* slot)
+{
+    for (u32 i = 0; i < ENTRIES; i++) {
+        u32 expected = TARGET_FREE;
+        if (targets[i].compare_exchange_strong(expected, TARGET_BUSY)) {
+            slots[i] = slot;
+            targets[i].store(target, std::memory_order_release);
+            return;
+        }
+        // Another thread might have inserted the same target already
+        if (expected == target) {
+            return;
+        }
+    }
+}
+
+/**
+ * Recompiler utilities
+ */
+void ppuDispatch(State* state, u32 addr, u64* gpr, f64* fpr)
+{
+    EntryPoint entry = nucleus.cell.ppu_dispatch.find(addr);
+    if (entry) {
+        entry(state, gpr, fpr);
+        return;
+    }
+
+    // Target not recompiled (e.g. outside any analyzed function, or an unlinked import stub)
+    auto* thread = (Thread*)nucleus.cell.getCurrentThread();
+    thread->interpret(addr, gpr, fpr);
+}
+
+void ppuIndirectCall(State* state, InlineCache* cache, u32 target, u64* gpr, f64* fpr)
+{
+    g_inlineCacheMisses.fetch_add(1, std::memory_order_relaxed);
+
+    EntryPoint entry = nucleus.cell.ppu_dispatch.find(target);
+    if (entry) {
+        cache->insert(target, &nucleus.cell.ppu_dispatch.at(target));
+        entry(state, gpr, fpr);
+        return;
+    }
+
+    // Target not recompiled (yet)
+    auto* thread = (Thread*)nucleus.cell.getCurrentThread();
+    thread->interpret(target, gpr, fpr);
+}
+
+void ppuInterpretInstruction(u32 pc)
+{
+    auto* thread = (Thread*)nucleus.cell.getCurrentThread();
+    thread->interpretInstruction(pc);
+}
+
+void ppuInterpretFrom(u32 pc)
+{
+    auto* thread = (Thread*)nucleus.cell.getCurrentThread();
+    thread->interpretFrom(pc);
+}
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,177 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace cpu {
+namespace ppu {
+
+// Class declarations
+struct State;
+
+/**
+ * Entry points:
+ * Recompiled functions are entered through a wrapper with a fixed native signature, which reads
+ * the arguments from the guest registers and writes the return value back to them. This avoids
+ * going through the generic ExecutionEngine::runFunction path for every call from the host.
+ * The wrapper also passes the state of the calling thread and the guest memory base to the function.
+ */
+typedef void (*EntryPoint)(State* state, u64* gpr, f64* fpr);
+
+/**
+ * Address table:
+ * Maps guest instruction addresses to values in constant time, lock-free for readers.
+ * The 4 GB guest address space is covered by a two-level table: The first level indexes 64 KB
+ * pages of guest memory and the second level the instructions inside them, allocated on demand.
+ */
+template <typename T>
+class AddressTable
+{
+    static const u32 PAGE_BITS = 16;
+    static const u32 PAGE_COUNT = 1 << (32 - PAGE_BITS);
+    static const u32 PAGE_ENTRIES = 1 << (PAGE_BITS - 2);
+
+    typedef std::atomic<T> Entry;
+
+    // First level of the table, unused pages are null
+    std::atomic<Entry*>* m_pages;
+
+    // Serializes the allocation of pages
+    std::mutex m_mutex;
+
+    static u32 getIndex(u32 addr) {
+        return (addr & ((1 << PAGE_BITS) - 1)) >> 2;
+    }
+
+public:
+    AddressTable() {
+        m_pages = new std::atomic<Entry*>[PAGE_COUNT]();
+    }
+
+    ~AddressTable() {
+        for (u32 i = 0; i < PAGE_COUNT; i++) {
+            delete[] m_pages[i].load();
+        }
+        delete[] m_pages;
+    }
+
+    // Get the value at the specified address, or a zero value if there is none
+    T find(u32 addr) const {
+        const Entry* page = m_pages[addr >> PAGE_BITS].load(std::memory_order_acquire);
+        if (!page) {
+            return T();
+        }
+        return page[getIndex(addr)].load(std::memory_order_acquire);
+    }
+
+    // Get the entry of the specified address, allocating its page if necessary
+    Entry& at(u32 addr) {
+        std::atomic<Entry*>& pageEntry = m_pages[addr >> PAGE_BITS];
+        Entry* page = pageEntry.load(std::memory_order_acquire);
+        if (!page) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            page = pageEntry.load(std::memory_order_acquire);
+            if (!page) {
+                page = new Entry[PAGE_ENTRIES]();
+                pageEntry.store(page, std::memory_order_release);
+            }
+        }
+        return page[getIndex(addr)];
+    }
+
+    // Set the value at the specified address
+    void set(u32 addr, T value) {
+        at(addr).store(value, std::memory_order_release);
+    }
+
+    // Reset the values of all addresses in the specified range
+    void clear(u32 addr, u32 size) {
+        // Pages are kept allocated, since other threads might be reading them
+        for (u64 i = addr & ~0x3; i < (u64)addr + size; i += 4) {
+            Entry* page = m_pages[i >> PAGE_BITS].load(std::memory_order_acquire);
+            if (!page) {
+                i |= (1 << PAGE_BITS) - 4;
+                continue;
+            }
+            page[getIndex(i)].store(T(), std::memory_order_release);
+        }
+    }
+};
+
+// Entry points of the recompiled functions
+typedef AddressTable<EntryPoint> DispatchTable;
+
+/**
+ * Inline caches:
+ * Each indirect branch site (bctr/bctrl) of the recompiled code owns a small polymorphic cache,
+ * checked inline before calling through the runtime. Entries are written once: A free entry is
+ * claimed by swapping its target from 0 to 1, then its dispatch table slot is stored and its target
+ * is published. Since slots are never freed, they always hold the current code of the target,
+ * even after it is recompiled by the tiered translator, and entries never need to be invalidated.
+ * NOTE: The recompiler defines each cache as a global variable with the same layout.
+ */
+struct InlineCache
+{
+    static const u32 ENTRIES = 2;
+
+    enum : u32 {
+        TARGET_FREE = 0,
+        TARGET_BUSY = 1,
+    };
+
+    std::atomic<u32> targets[ENTRIES];
+    std::atomic<EntryPoint>* slots[ENTRIES];
+
+    // Remember the dispatch table slot of a target, if there are free entries left
+    void insert(u32 target, std::atomic<EntryPoint>* slot);
+};
+
+// Number of indirect calls missing the inline caches, resolved by the runtime
+extern std::atomic<u64> g_inlineCacheMisses;
+
+/**
+ * Import links:
+ * Calls to the import stubs of a segment are linked directly to the recompiled code of the imported
+ * function, skipping the stub and the indirect call it ends with. Each stub owns a link, filled from
+ * the import table whenever modules are loaded, started or unloaded. Empty links (e.g. imported
+ * functions not recompiled, or implemented by the host) make the call go through the stub instead.
+ * NOTE: The recompiler accesses the links of a segment as a global array with the same layout.
+ */
+struct ImportLink
+{
+    std::atomic<EntryPoint> entry;  // Entry point of the imported function, or null if not linked
+    u32 toc;                        // TOC base of the imported function, written before the entry point
+    u32 slot;                       // Import table entry read by the stub, holding the function descriptor address
+};
+
+/**
+ * Recompiler utilities:
+ * Call the function at the specified address from recompiled code, through its entry point or the interpreter.
+ */
+void ppuDispatch(State* state, u32 addr, u64* gpr, f64* fpr);
+
+/**
+ * Recompiler utilities:
+ * Call the target of an indirect branch that missed its inline cache: Look up the dispatch table,
+ * filling the inline cache on hits, and fall back to the interpreter if it is not recompiled.
+ */
+void ppuIndirectCall(State* state, InlineCache* cache, u32 target, u64* gpr, f64* fpr);
+
+/**
+ * Recompiler utilities:
+ * Mixed-mode execution. Recompiled code spills its registers into the state of the current thread
+ * before running the interpreter, either for a single instruction or from an address until the
+ * function returns, and reloads them afterwards.
+ */
+void ppuInterpretInstruction(u32 pc);
+void ppuInterpretFrom(u32 pc);
+
+}  // namespace ppu
+}  // namespace cpu
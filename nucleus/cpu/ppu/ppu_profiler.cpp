@@ -0,0 +1,135 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_profiler.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_decoder.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#ifdef NUCLEUS_PLATFORM_WINDOWS
+#define thread_local __declspec(thread)
+#elif NUCLEUS_PLATFORM_OSX
+#define thread_local __thread
+#endif
+
+namespace cpu {
+namespace ppu {
+
+// Cycles spent in the callees of the function being executed by this thread
+thread_local u64 g_childCycles = 0;
+
+Profiler::Profiler()
+{
+    m_entries = new Entry[TABLE_SIZE]();
+}
+
+Profiler::~Profiler()
+{
+    delete[] m_entries;
+}
+
+Profiler::Entry* Profiler::getEntry(u32 addr)
+{
+    const u32 hash = (addr >> 2) * 2654435761U;
+    for (u32 i = 0; i < TABLE_SIZE; i++) {
+        Entry& entry = m_entries[(hash + i) & (TABLE_SIZE - 1)];
+        u32 current = entry.addr.load(std::memory_order_acquire);
+        if (current == 0 && entry.addr.compare_exchange_strong(current, addr)) {
+            return &entry;
+        }
+        if (current == addr) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void Profiler::record(u32 addr, u32 tier, u64 inclusive, u64 exclusive)
+{
+    Entry* entry = getEntry(addr);
+    if (!entry || tier >= TIERS) {
+        return;
+    }
+    entry->calls[tier].fetch_add(1, std::memory_order_relaxed);
+    entry->inclusive[tier].fetch_add(inclusive, std::memory_order_relaxed);
+    entry->exclusive[tier].fetch_add(exclusive, std::memory_order_relaxed);
+}
+
+void Profiler::dump()
+{
+    std::vector<const Entry*> entries;
+    for (u32 i = 0; i < TABLE_SIZE; i++) {
+        if (m_entries[i].addr.load()) {
+            entries.push_back(&m_entries[i]);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) {
+        return a->getTotal(a->exclusive) > b->getTotal(b->exclusive);
+    });
+
+    nucleus.log.notice(LOG_CPU, "PPU function profile (%d functions):", entries.size());
+    nucleus.log.notice(LOG_CPU, "  Address   Calls             Inclusive cycles      Exclusive cycles      Name");
+    for (const Entry* entry : entries) {
+        const u32 addr = entry->addr.load();
+        std::string name;
+        std::lock_guard<std::mutex> lock(nucleus.cell.ppu_segments_mutex);
+        for (const Segment* segment : nucleus.cell.ppu_segments) {
+            auto it = segment->functions.find(addr);
+            if (it != segment->functions.end()) {
+                name = it->second.name;
+            }
+        }
+        nucleus.log.notice(LOG_CPU, "  %08X  %-16llu  %-20llu  %-20llu  %s", addr,
+            entry->getTotal(entry->calls), entry->getTotal(entry->inclusive), entry->getTotal(entry->exclusive), name.c_str());
+    }
+
+    // Tiered translator: Compare the exclusive cycles per call of the profiled and the optimized code
+    u64 profiledCycles = 0;
+    u64 optimizedCycles = 0;
+    u32 optimizedCount = 0;
+    for (const Entry* entry : entries) {
+        const u64 profiledCalls = entry->calls[1].load();
+        const u64 optimizedCalls = entry->calls[2].load();
+        if (!profiledCalls || !optimizedCalls) {
+            continue;
+        }
+        const double profiled = (double)entry->exclusive[1].load() / profiledCalls;
+        const double optimized = (double)entry->exclusive[2].load() / optimizedCalls;
+        nucleus.log.notice(LOG_CPU, "  Optimized %08X: %.0f -> %.0f cycles per call (%.2fx)",
+            entry->addr.load(), profiled, optimized, profiled / std::max(optimized, 1.0));
+
+        // Weighted by the calls to the optimized code, estimating the cycles saved
+        profiledCycles += (u64)(profiled * optimizedCalls);
+        optimizedCycles += entry->exclusive[2].load();
+        optimizedCount += 1;
+    }
+    if (optimizedCount) {
+        nucleus.log.notice(LOG_CPU, "Speed-up of %d optimized functions: %.2fx (%llu cycles instead of %llu)",
+            optimizedCount, (double)profiledCycles / std::max<u64>(optimizedCycles, 1), optimizedCycles, profiledCycles);
+    }
+}
+
+/**
+ * Recompiler utilities
+ */
+u64 ppuProfileEnter()
+{
+    const u64 parentChildCycles = g_childCycles;
+    g_childCycles = 0;
+    return parentChildCycles;
+}
+
+void ppuProfileExit(u32 addr, u32 tier, u64 cycles, u64 parentChildCycles)
+{
+    const u64 exclusive = cycles - std::min(g_childCycles, cycles);
+    g_childCycles = parentChildCycles + cycles;
+    nucleus.cell.ppu_profiler.record(addr, tier, cycles, exclusive);
+}
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,64 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include <atomic>
+
+namespace cpu {
+namespace ppu {
+
+/**
+ * Function profiler:
+ * With the profiling instrumentation, recompiled functions read the host cycle counter in their
+ * prolog and before returning. The calls, inclusive and exclusive cycles of each function are
+ * accumulated in a fixed-size open addressing table, which all threads update without locks.
+ * Statistics are kept per tier of the tiered translator, measuring the speed-up of optimized code.
+ */
+class Profiler
+{
+    static const u32 TABLE_SIZE = 1 << 16;
+    static const u32 TIERS = 3;
+
+    struct Entry
+    {
+        std::atomic<u32> addr;              // Function address (0 if the entry is unused)
+        std::atomic<u64> calls[TIERS];
+        std::atomic<u64> inclusive[TIERS];  // Cycles spent in the function and its callees
+        std::atomic<u64> exclusive[TIERS];  // Cycles spent in the function itself
+
+        u64 getTotal(const std::atomic<u64>* values) const {
+            return values[0].load() + values[1].load() + values[2].load();
+        }
+    };
+
+    Entry* m_entries;
+
+    // Get the entry of a function, claiming a new one if necessary (null if the table is full)
+    Entry* getEntry(u32 addr);
+
+public:
+    Profiler();
+    ~Profiler();
+
+    // Add a call to the statistics of a function, executing the code of the specified tier
+    void record(u32 addr, u32 tier, u64 inclusive, u64 exclusive);
+
+    // Log the statistics of every function, sorted by exclusive cycles, and the speed-up of optimized functions
+    void dump();
+};
+
+/**
+ * Recompiler utilities:
+ * Called from the prolog and before returning from recompiled functions. Cycles spent in callees
+ * are accumulated per thread to compute the exclusive cycles of the caller.
+ */
+u64 ppuProfileEnter();
+void ppuProfileExit(u32 addr, u32 tier, u64 cycles, u64 parentChildCycles);
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,197 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_spin.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_tables.h"
+#include "nucleus/cpu/ppu/ppu_thread.h"
+#include "nucleus/cpu/ppu/analyzer/ppu_analyzer.h"
+
+#include <thread>
+#if defined(NUCLEUS_ARCH_X86_64)
+#include <emmintrin.h>
+#endif
+
+namespace cpu {
+namespace ppu {
+
+enum SpinInstructionType {
+    SPIN_INVALID = 0,  // Instruction might have side effects: Not a spin loop
+    SPIN_LOAD,         // Instruction loads memory without updating the base register
+    SPIN_OTHER,        // Instruction has no side effects visible to other threads
+};
+
+static SpinInstructionType getSpinType(Instruction code)
+{
+    switch (code.opcode) {
+    case 0x20: // lwz
+    case 0x22: // lbz
+    case 0x28: // lhz
+    case 0x2A: // lha
+        return SPIN_LOAD;
+    case 0x3A: // ld, lwa
+        return (code.op58 == 0 || code.op58 == 2) ? SPIN_LOAD : SPIN_INVALID;
+    case 0x0A: // cmpli
+    case 0x0B: // cmpi
+    case 0x0E: // addi
+    case 0x0F: // addis
+    case 0x15: // rlwinm
+    case 0x18: // ori
+    case 0x19: // oris
+    case 0x1A: // xori
+    case 0x1C: // andi.
+    case 0x1D: // andis.
+    case 0x1E: // rld*
+        return SPIN_OTHER;
+    case 0x13: // isync
+        return (code.op19 == 0x096) ? SPIN_OTHER : SPIN_INVALID;
+    case 0x1F:
+        switch (code.op31) {
+        case 0x017: // lwzx
+        case 0x057: // lbzx
+        case 0x117: // lhzx
+        case 0x015: // ldx
+        case 0x014: // lwarx
+        case 0x054: // ldarx
+            return SPIN_LOAD;
+        case 0x000: // cmp
+        case 0x020: // cmpl
+        case 0x01C: // and
+        case 0x1BC: // or
+        case 0x13C: // xor
+        case 0x10A: // add
+        case 0x028: // subf
+        case 0x153: // mfspr
+        case 0x256: // sync
+        case 0x356: // eieio
+            return SPIN_OTHER;
+        }
+        return SPIN_INVALID;
+    }
+    return SPIN_INVALID;
+}
+
+bool isSpinLoad(Instruction code)
+{
+    return getSpinType(code) == SPIN_LOAD;
+}
+
+bool isSpinLoop(u32 start, u32 branch)
+{
+    if (start >= branch || (branch - start) / 4 >= SPIN_LOOP_MAX_INSTRUCTIONS) {
+        return false;
+    }
+
+    // Loops counted with CTR or calling functions always make progress
+    const Instruction bc = { nucleus.memory.read32(branch) };
+    if (bc.opcode != 0x10 || bc.lk || bc.aa || !(bc.bo & 0x04)) {
+        return false;
+    }
+    if (branch + (bc.bd << 2) != start) {
+        return false;
+    }
+
+    // Registers holding loaded values, the only ones the body might write
+    bool loaded[32] = {};
+    for (u32 addr = start; addr < branch; addr += 4) {
+        const Instruction code = { nucleus.memory.read32(addr) };
+        if (getSpinType(code) == SPIN_LOAD) {
+            loaded[code.rd] = true;
+        }
+    }
+
+    bool hasLoad = false;
+    for (u32 addr = start; addr < branch; addr += 4) {
+        const Instruction code = { nucleus.memory.read32(addr) };
+
+        // Conditional branches leaving the loop are allowed, as long as they do not decrement CTR
+        if (code.opcode == 0x10 && !code.lk && !code.aa) {
+            const u32 target = addr + (code.bd << 2);
+            if ((target > branch || target < start) && (code.bo & 0x04)) {
+                continue;
+            }
+            return false;
+        }
+
+        switch (getSpinType(code)) {
+        case SPIN_LOAD:
+            // The address of the polled word is computed at the branch, so its base and index
+            // registers must keep their values through the body (e.g. not lwz r3,0(r3))
+            if (!hasLoad && ((code.ra && loaded[code.ra]) || (code.opcode == 0x1F && loaded[code.rb]))) {
+                return false;
+            }
+            hasLoad = true;
+            break;
+        case SPIN_OTHER:
+            break;
+        default:
+            return false;
+        }
+
+        // Loops updating other registers (e.g. counters, scanned addresses) make progress on each iteration
+        Analyzer status;
+        auto method = get_entry(code).analyze;
+        (status.*method)(code);
+        for (u32 i = 0; i < 32; i++) {
+            if ((status.gpr[i] & REG_WRITE) && !loaded[i]) {
+                return false;
+            }
+        }
+        if (status.ctr & REG_WRITE) {
+            return false;
+        }
+    }
+    return hasLoad;
+}
+
+u32 findSpinLoad(u32 start)
+{
+    for (u32 i = 0; i < SPIN_LOOP_MAX_INSTRUCTIONS; i++) {
+        const Instruction code = { nucleus.memory.read32(start + 4 * i) };
+        if (isSpinLoad(code)) {
+            return start + 4 * i;
+        }
+    }
+    return 0;
+}
+
+void SpinBackoff::wait(u32 pc, u32 addr)
+{
+    // Any change of the polled word means the loop is making progress
+    addr &= ~0x3;
+    const u32 value = nucleus.memory.read32(addr);
+    if (pc != m_pc || addr != m_addr || value != m_value) {
+        m_pc = pc;
+        m_addr = addr;
+        m_value = value;
+        m_count = 0;
+        return;
+    }
+
+    m_count++;
+    if (m_count < PAUSE_ITERATIONS) {
+#if defined(NUCLEUS_ARCH_X86_64)
+        _mm_pause();
+#endif
+    }
+    else if (m_count < YIELD_ITERATIONS) {
+        std::this_thread::yield();
+    }
+    else {
+        nucleus.memory.waitWrite(addr, value, WAIT_TIMEOUT_US);
+    }
+}
+
+/**
+ * Recompiler utilities
+ */
+void ppuSpinWait(u32 pc, u32 addr)
+{
+    auto* thread = (Thread*)nucleus.cell.getCurrentThread();
+    thread->state->spin.wait(pc, addr);
+}
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,77 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/ppu/ppu_instruction.h"
+
+namespace cpu {
+namespace ppu {
+
+/**
+ * Spin-loop detection:
+ * Short loops closed by a conditional backward branch, whose body only loads memory, and
+ * compares or computes values from the loaded registers without writing any other register.
+ * The base and index registers of the first load, the polled word, must not be written either.
+ * Such loops cannot make progress until another thread writes the polled memory, so the
+ * emulated thread backs off instead of burning a host core. Load-and-reserve loops retrying
+ * a conditional store are not spin loops, since the store fails due to contention.
+ */
+static const u32 SPIN_LOOP_MAX_INSTRUCTIONS = 16;
+
+// Check whether the loop [start, branch] is a spin loop
+bool isSpinLoop(u32 start, u32 branch);
+
+// Check whether the instruction is a load allowed in spin loops, the first one is the polled word
+bool isSpinLoad(Instruction code);
+
+// Get the address of the first load of the spin loop starting at the address, or 0 if there is none
+u32 findSpinLoad(u32 start);
+
+// Get the effective address of a spin loop load from the values of its base and index registers
+inline u32 getSpinLoadAddress(Instruction load, u64 ra, u64 rb) {
+    if (load.opcode == 0x1F) {
+        return (load.ra ? ra : 0) + rb;
+    }
+    if (load.opcode == 0x3A) {
+        return (load.ra ? ra : 0) + (load.ds << 2);
+    }
+    return (load.ra ? ra : 0) + load.d;
+}
+
+/**
+ * Spin backoff:
+ * Called on every iteration of a detected spin loop. The polled address and word are compared
+ * against the previous iteration, and any change resets the backoff. Otherwise the thread pauses, then
+ * yields its time slice, and finally waits until the page holding the polled word is written.
+ */
+class SpinBackoff
+{
+    static const u32 PAUSE_ITERATIONS = 64;
+    static const u32 YIELD_ITERATIONS = 256;
+    static const u32 WAIT_TIMEOUT_US = 1000;
+
+    u32 m_pc = 0;
+    u32 m_addr = 0;
+    u32 m_value = 0;
+    u32 m_count = 0;
+
+public:
+    void wait(u32 pc, u32 addr);
+
+    void reset() {
+        m_count = 0;
+    }
+};
+
+/**
+ * Recompiler utilities:
+ * Wrapper with a plain signature to be called from recompiled code.
+ */
+void ppuSpinWait(u32 pc, u32 addr);
+
+}  // namespace ppu
+}  // namespace cpu
@@ -8,41 +8,39 @@
 
 #include "llvm/IR/LLVMContext.h"
 
+#include <cfenv>
+#if defined(NUCLEUS_ARCH_X86_64)
+#include <pmmintrin.h>
+#endif
+
 namespace cpu {
 namespace ppu {
 
-llvm::StructType* State::type()
+void State::updateHostFloatEnv()
 {
-    llvm::StructType* ppuStateType = llvm::StructType::get(llvm::getGlobalContext(), std::vector<llvm::Type*>{
-        llvm::ArrayType::get( llvm::Type::getInt64Ty(llvm::getGlobalContext()),  32 ), // GPR's
-        llvm::ArrayType::get( llvm::Type::getDoubleTy(llvm::getGlobalContext()), 32 ), // FPR's
-        llvm::ArrayType::get( llvm::Type::getInt64Ty(llvm::getGlobalContext()),  96 ), // TODO: Other registers
-    });
-
-    return ppuStateType;
+    // Rounding mode
+    static const int rounding[] = { FE_TONEAREST, FE_TOWARDZERO, FE_UPWARD, FE_DOWNWARD };
+    std::fesetround(rounding[fpscr.RN]);
+
+    // Denormal inputs and results are flushed to zero by the host in non-Java mode.
+    // This also affects scalar instructions, hence it is only done if requested.
+#if defined(NUCLEUS_ARCH_X86_64)
+    if (hostNJ) {
+        _MM_SET_FLUSH_ZERO_MODE(vscr.NJ ? _MM_FLUSH_ZERO_ON : _MM_FLUSH_ZERO_OFF);
+        _MM_SET_DENORMALS_ZERO_MODE(vscr.NJ ? _MM_DENORMALS_ZERO_ON : _MM_DENORMALS_ZERO_OFF);
+    }
+#endif
 }
 
-void State::declareGlobalState(llvm::Module* module)
+llvm::StructType* State::type(llvm::LLVMContext& context)
 {
-    module->getOrInsertGlobal("ppuState", State::type());
-
-    // Configure global PPU state
-    llvm::GlobalVariable* ppuState = module->getNamedGlobal("ppuState");
-    ppuState->setConstant(false);
-    ppuState->setThreadLocal(true);
-    ppuState->setLinkage(llvm::GlobalValue::ExternalLinkage);
-    ppuState->setInitializer(llvm::ConstantAggregateZero::get(State::type()));
-}
-
-llvm::Value* State::readGPR(llvm::IRBuilder<>& builder, int index)
-{
-    llvm::Module* module = builder.GetInsertBlock()->getParent()->getParent();
-    llvm::GlobalVariable* ppuState = module->getNamedGlobal("ppuState");
+    llvm::StructType* ppuStateType = llvm::StructType::get(context, std::vector<llvm::Type*>{
+        llvm::ArrayType::get( llvm::Type::getInt64Ty(context),  32 ), // GPR's
+        llvm::ArrayType::get( llvm::Type::getDoubleTy(context), 32 ), // FPR's
+        llvm::ArrayType::get( llvm::Type::getInt64Ty(context),  96 ), // TODO: Other registers
+    });
 
-    llvm::Value* location = nullptr;
-    location = builder.CreateStructGEP(ppuState, 0);
-    location = builder.CreateStructGEP(location, index);
-    return builder.CreateLoad(location);
+    return ppuStateType;
 }
 
 }  // namespace ppu
@@ -7,6 +7,8 @@
 
 #include "nucleus/common.h"
 #include "nucleus/cpu/thread.h"
+#include "nucleus/cpu/ppu/ppu_spin.h"
+#include "nucleus/memory/reservation.h"
 
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Module.h"
@@ -68,10 +70,14 @@ enum FPSCR_EXP {
 typedef u64 PPU_GPR;
 
 // Condition Register
-union PPU_CR
+struct PPU_CR
 {
     u32 CR;
 
+    // Lazy flags: Signed result from which field 0 is computed once it is read
+    s64 pendingResult;
+    bool pending;
+
     // Bit index
     enum {
         CR_LT = 0,
@@ -80,11 +86,26 @@ union PPU_CR
         CR_SO = 3,
     };
 
-    u8 getBit(u32 bit) { return (CR >> bit) & 1; }
-    void setBit(u32 bit, bool value) { CR = value ? CR | (1 << bit) : CR & ~(1 << bit); }
+    // Materialize the pending field, required before accessing CR directly
+    void sync() {
+        if (pending) {
+            pending = false;
+            updateField(0, pendingResult, (s64)0);
+        }
+    }
+    void setPending(s64 result) {
+        pendingResult = result;
+        pending = true;
+    }
 
-    u8 getField(u32 field) { return (CR >> field*4) & 0xf; }
+    u8 getBit(u32 bit) { sync(); return (CR >> bit) & 1; }
+    void setBit(u32 bit, bool value) { sync(); CR = value ? CR | (1 << bit) : CR & ~(1 << bit); }
+
+    u8 getField(u32 field) { sync(); return (CR >> field*4) & 0xf; }
     void setField(u32 field, u8 value) {
+        if (field == 0) {
+            pending = false;
+        }
         u64 maskHigh = ~((1ULL << (field+1)*4)-1);
         u64 maskLow = ((1ULL << field*4)-1);
         CR = (CR & (u32)maskHigh) | (value << field*4) | (CR & (u32)maskLow);
@@ -144,40 +165,78 @@ union PPU_FPR
 };
 
 // Floating-Point Status and Control Register
-union PPU_FPSCR
+struct PPU_FPSCR
 {
-    u32 FPSCR;
-
-    struct {
-        u32 RN      :2; // Rounding control
-        u32 NI      :1; // Non-IEEE mode
-        u32 XE      :1; // Inexact exception enable
-        u32 ZE      :1; // IEEE Zero divide exception enable
-        u32 UE      :1; // IEEE Underflow exception enable
-        u32 OE      :1; // IEEE Overflow exception enable
-        u32 VE      :1; // Invalid operation exception enable
-        u32 VXCVI   :1; // Invalid operation exception for invalid integer convert
-        u32 VXSQRT  :1; // Invalid operation exception for invalid square root
-        u32 VXSOFT  :1; // Invalid operation exception for software request
-        u32         :1;
-        u32 FPRF    :5; // Result flags
-        u32 FI      :1; // Fraction inexact
-        u32 FR      :1; // Fraction rounded
-        u32 VXVC    :1; // Invalid operation exception for invalid compare
-        u32 VXIMZ   :1; // Invalid operation exception for Inf * 0
-        u32 VXZDZ   :1; // Invalid operation exception for 0 / 0
-        u32 VXIDI   :1; // Invalid operation exception for Inf + Inf
-        u32 VXISI   :1; // Invalid operation exception for Inf - Inf
-        u32 VXSNAN  :1; // Invalid operation exception for SNaN
-        u32 XX      :1; // Inexact exception
-        u32 ZX      :1; // Zero divide exception
-        u32 UX      :1; // Underflow exception
-        u32 OX      :1; // Overflow exception
-        u32 VX      :1; // Invalid operation exception summary
-        u32 FEX     :1; // Enabled exception summary
-        u32 FX      :1; // Exception summary
+    union {
+        u32 FPSCR;
+        struct {
+            u32 RN      :2; // Rounding control
+            u32 NI      :1; // Non-IEEE mode
+            u32 XE      :1; // Inexact exception enable
+            u32 ZE      :1; // IEEE Zero divide exception enable
+            u32 UE      :1; // IEEE Underflow exception enable
+            u32 OE      :1; // IEEE Overflow exception enable
+            u32 VE      :1; // Invalid operation exception enable
+            u32 VXCVI   :1; // Invalid operation exception for invalid integer convert
+            u32 VXSQRT  :1; // Invalid operation exception for invalid square root
+            u32 VXSOFT  :1; // Invalid operation exception for software request
+            u32         :1;
+            u32 FPRF    :5; // Result flags
+            u32 FI      :1; // Fraction inexact
+            u32 FR      :1; // Fraction rounded
+            u32 VXVC    :1; // Invalid operation exception for invalid compare
+            u32 VXIMZ   :1; // Invalid operation exception for Inf * 0
+            u32 VXZDZ   :1; // Invalid operation exception for 0 / 0
+            u32 VXIDI   :1; // Invalid operation exception for Inf + Inf
+            u32 VXISI   :1; // Invalid operation exception for Inf - Inf
+            u32 VXSNAN  :1; // Invalid operation exception for SNaN
+            u32 XX      :1; // Inexact exception
+            u32 ZX      :1; // Zero divide exception
+            u32 UX      :1; // Underflow exception
+            u32 OX      :1; // Overflow exception
+            u32 VX      :1; // Invalid operation exception summary
+            u32 FEX     :1; // Enabled exception summary
+            u32 FX      :1; // Exception summary
+        };
     };
 
+    // Lazy flags: Result from which FPRF is computed once it is read
+    f64 pendingResult;
+    bool pending;
+
+    // Return the FPRF field describing the given result
+    static u32 getFPRF(f64 value) {
+        switch (std::fpclassify(value)) {
+        case FP_NAN:        return FPR_FPRF_QNAN;
+        case FP_INFINITE:   return std::signbit(value) ? FPR_FPRF_NINF : FPR_FPRF_PINF;
+        case FP_SUBNORMAL:  return std::signbit(value) ? FPR_FPRF_ND : FPR_FPRF_PD;
+        case FP_ZERO:       return std::signbit(value) ? FPR_FPRF_NZ : FPR_FPRF_PZ;
+        default:            return std::signbit(value) ? FPR_FPRF_NN : FPR_FPRF_PN;
+        }
+    }
+
+    // Rebuild the VX and FEX summary bits from the sticky exception bits
+    void syncSummary() {
+        VX = (FPSCR & (FPSCR_VXSNAN | FPSCR_VXISI | FPSCR_VXIDI | FPSCR_VXZDZ | FPSCR_VXIMZ |
+            FPSCR_VXVC | FPSCR_VXSOFT | FPSCR_VXSQRT | FPSCR_VXCVI)) != 0;
+        FEX = (VX & VE) | (OX & OE) | (UX & UE) | (ZX & ZE) | (XX & XE);
+    }
+
+    // Materialize the pending fields, required before accessing FPSCR directly
+    void sync() {
+        if (pending) {
+            pending = false;
+            FPRF = getFPRF(pendingResult);
+        }
+        syncSummary();
+    }
+    void setPending(f64 result) {
+        pendingResult = result;
+        pending = true;
+    }
+
+    void setFPRF(u32 value) { pending = false; FPRF = value; }
+
     void setException(const u32 mask) {
         if ((FPSCR & mask) != mask) {
             FX = 1;
@@ -187,17 +246,46 @@ union PPU_FPSCR
 };
 
 // XER Register (SPR 1)
-union PPU_XER
+struct PPU_XER
 {
-    u64 XER;
-    struct {
-        u32 BC : 7;  // Byte count
-        u32    : 22;
-        u32 CA : 1;  // Carry
-        u32 OV : 1;  // Overflow
-        u32 SO : 1;  // Summary overflow
-        u32    : 32;
+    union {
+        u64 XER;
+        struct {
+            u32 BC : 7;  // Byte count
+            u32    : 22;
+            u32 CA : 1;  // Carry
+            u32 OV : 1;  // Overflow
+            u32 SO : 1;  // Summary overflow
+            u32    : 32;
+        };
     };
+
+    // Lazy flags: Number and values of the addends from which CA is computed once it is read
+    u64 pendingAddends[3];
+    u8 pending;
+
+    // Materialize the pending carry, required before accessing XER directly
+    void sync() {
+        if (pending) {
+            const u64 sum = pendingAddends[0] + pendingAddends[1];
+            CA = (sum < pendingAddends[0]) || (pending == 3 && (sum + pendingAddends[2]) < sum);
+            pending = 0;
+        }
+    }
+    void setPending(u64 a, u64 b) {
+        pendingAddends[0] = a;
+        pendingAddends[1] = b;
+        pending = 2;
+    }
+    void setPending(u64 a, u64 b, u64 c) {
+        pendingAddends[0] = a;
+        pendingAddends[1] = b;
+        pendingAddends[2] = c;
+        pending = 3;
+    }
+
+    u8 getCA() { sync(); return CA; }
+    void setCA(bool value) { pending = 0; CA = value; }
 };
 
 // LR Register (SPR 8)
@@ -266,22 +354,75 @@ struct State {
     PPU_VR vr[32] = {};
     PPU_VSCR vscr = {};
 
-    // Reservation Registers
-    u64 reserve_addr = 0;
-    u64 reserve_value = 0;
+    // Reservation
+    Reservation reservation = {};
+
+    // Backoff of the spin loop being executed
+    SpinBackoff spin;
 
     // Program Counter
     u32 pc;
 
+    // Defer CR0 and XER[CA] updates until they are read
+    bool lazyFlags = false;
+
+    // Floating-point accuracy
+    bool lazyFPRF = false;  // Defer FPSCR[FPRF] updates until they are read
+    bool skipFPRF = false;  // Never update FPSCR[FPRF] after arithmetic instructions
+    bool hostNJ = false;    // Map VSCR[NJ] to the host denormal flushing modes
+
+    // Update the flags of record-form and carrying instructions
+    void updateCR0(s64 result) {
+        if (lazyFlags) {
+            cr.setPending(result);
+        }
+        else {
+            cr.updateField(0, result, (s64)0);
+        }
+    }
+    void updateCA(u64 a, u64 b) {
+        if (lazyFlags) {
+            xer.setPending(a, b);
+        }
+        else {
+            xer.CA = (a + b) < a;
+        }
+    }
+    void updateCA(u64 a, u64 b, u64 c) {
+        if (lazyFlags) {
+            xer.setPending(a, b, c);
+        }
+        else {
+            xer.CA = ((a + b) < a) || ((a + b + c) < (a + b));
+        }
+    }
+
+    // Update the flags of floating-point instructions
+    void updateFPRF(f64 result) {
+        if (skipFPRF) {
+            return;
+        }
+        if (lazyFPRF) {
+            fpscr.setPending(result);
+        }
+        else {
+            fpscr.FPRF = PPU_FPSCR::getFPRF(result);
+        }
+    }
+    void updateCR1() {
+        fpscr.syncSummary();
+        cr.setField(1, fpscr.FPSCR >> 28);
+    }
+
+    // Apply FPSCR[RN] and VSCR[NJ] to the floating-point environment of the host thread
+    void updateHostFloatEnv();
+
     /**
      * Recompiler utilities
      */
 
     // Get the LLVM type of this class
-    static llvm::StructType* type();
-
-    static void declareGlobalState(llvm::Module* module);
-    static llvm::Value* readGPR(llvm::IRBuilder<>& builder, int index);
+    static llvm::StructType* type(llvm::LLVMContext& context);
 };
 
 }  // namespace ppu
@@ -7,6 +7,9 @@
 #include "nucleus/cpu/ppu/interpreter/ppu_interpreter.h"
 #include "nucleus/cpu/ppu/ppu_thread.h"
 
+#include <unordered_map>
+#include <vector>
+
 // Instruction entry
 #define INSTRUCTION(name) { ENTRY_INSTRUCTION, nullptr, #name, &Analyzer::name, &Interpreter::name, &Recompiler::name }
 
@@ -497,10 +500,51 @@ static const struct table63_ext_t : Table<0x400> {
     }
 } table63_;
 
+/**
+ * Flat table:
+ * All extended opcode fields are contained in the 11 least significant bits of the
+ * instruction, so the primary opcode along with those bits identify any instruction.
+ * The table maps them to indices of the distinct entries, resolving an instruction
+ * with a single lookup and no calls. It is generated from the tables above, which
+ * must be initialized before it (i.e. defined earlier in this file).
+ */
+static const struct table_flat_t {
+    static const u32 SIZE = 0x40 << 11;
+
+    std::vector<const Entry*> entries;
+    u16 index[SIZE];
+
+    table_flat_t() {
+        static const Entry invalid = {};
+        std::unordered_map<const Entry*, u16> indices;
+        entries.push_back(&invalid);
+
+        for (u32 i = 0; i < SIZE; i++) {
+            const Instruction code = { ((i >> 11) << 26) | (i & 0x7FF) };
+            const Entry& entry = get_entry_nested(code);
+            if (entry.type == ENTRY_INVALID) {
+                index[i] = 0;
+                continue;
+            }
+            auto it = indices.find(&entry);
+            if (it == indices.end()) {
+                it = indices.emplace(&entry, (u16)entries.size()).first;
+                entries.push_back(&entry);
+            }
+            index[i] = it->second;
+        }
+    }
+} tableFlat;
+
 /**
  * Return entries from tables
  */
 const Entry& get_entry(Instruction code)
+{
+    return *tableFlat.entries[tableFlat.index[(code.opcode << 11) | (code.instruction & 0x7FF)]];
+}
+
+const Entry& get_entry_nested(Instruction code)
 {
     if (tablePrimary[code.opcode].type == ENTRY_TABLE) {
         return tablePrimary[code.opcode].caller(code);
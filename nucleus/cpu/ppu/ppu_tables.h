@@ -40,6 +40,7 @@ struct Entry
 
 // Instruction callers
 const Entry& get_entry(Instruction code);
+const Entry& get_entry_nested(Instruction code);  // Walks the nested tables, slower than get_entry
 const Entry& get_table4  (Instruction code);
 const Entry& get_table4_ (Instruction code);
 const Entry& get_table19 (Instruction code);
@@ -6,10 +6,9 @@
 #include "ppu_thread.h"
 #include "nucleus/config.h"
 #include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_dispatch.h"
 #include "nucleus/cpu/ppu/interpreter/ppu_interpreter.h"
 
-#include "llvm/ExecutionEngine/GenericValue.h"
-
 namespace cpu {
 namespace ppu {
 
@@ -19,14 +18,17 @@ Thread::Thread(u32 entry)
     m_stackAddr = nucleus.memory(SEG_STACK).alloc(0x10000, 0x100);
     m_stackPointer = m_stackAddr + 0x10000;
 
-    if (config.ppuTranslator == PPU_TRANSLATOR_INTERPRETER) {
-        interpreter = new Interpreter(entry, m_stackPointer);
-        state = &(interpreter->state);
+    // Recompiled code shares the state of the interpreter, which executes everything it does not support
+    interpreter = new Interpreter(entry, m_stackPointer);
+    state = &(interpreter->state);
+    if (config.ppuTranslator == PPU_TRANSLATOR_INTERPRETER || config.ppuTranslator == PPU_TRANSLATOR_TIERED) {
+        state->lazyFlags = config.ppuLazyFlags;
     }
 
-    if (config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
-        state = new State();
-    }
+    // Floating-point accuracy
+    state->lazyFPRF = (config.ppuFloatAccuracy == PPU_FLOAT_LAZY);
+    state->skipFPRF = (config.ppuFloatAccuracy == PPU_FLOAT_FAST);
+    state->hostNJ = (config.ppuFloatAccuracy == PPU_FLOAT_FAST);
 
     const u32 entry_pc = nucleus.memory.read32(entry);
     const u32 entry_rtoc = nucleus.memory.read32(entry+4);
@@ -57,16 +59,12 @@ Thread::Thread(u32 entry)
 
 Thread::~Thread()
 {
-    // Destroy stack
+    // Destroy stack and drop the reservation held by the thread, if any
     nucleus.memory(SEG_STACK).free(m_stackAddr);
+    nucleus.memory.reservations.release(state->reservation);
 
     // Delete translators
-    if (config.ppuTranslator == PPU_TRANSLATOR_INTERPRETER) {
-        delete interpreter;
-    }
-    if (config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
-        delete state;
-    }
+    delete interpreter;
 }
 
 void Thread::start()
@@ -92,68 +90,117 @@ void Thread::start()
 
 void Thread::task()
 {
-    if (config.ppuTranslator == PPU_TRANSLATOR_INTERPRETER) {
-        while (true) {
-            // Handle events
-            if (m_event) {
-                std::unique_lock<std::mutex> lock(m_mutex);
-                if (m_event == NUCLEUS_EVENT_PAUSE) {
-                    m_status = NUCLEUS_STATUS_PAUSED;
-                    m_cv.wait(lock, [&]{ return m_event == NUCLEUS_EVENT_RUN; });
-                    m_status = NUCLEUS_STATUS_RUNNING;
-                }
-                if (m_event == NUCLEUS_EVENT_STOP) {
-                    break;
-                }
-                m_event = NUCLEUS_EVENT_NONE;
+    // Both translators rely on the host rounding and denormal modes
+    state->updateHostFloatEnv();
+
+    const bool tiered = (config.ppuTranslator == PPU_TRANSLATOR_TIERED);
+    const bool recompiled = (config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER || tiered);
+    while (true) {
+        // Handle events
+        if (m_event) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_event == NUCLEUS_EVENT_PAUSE) {
+                m_status = NUCLEUS_STATUS_PAUSED;
+                m_cv.wait(lock, [&]{ return m_event != NUCLEUS_EVENT_PAUSE; });
+                m_status = NUCLEUS_STATUS_RUNNING;
             }
-            // Callback finished
-            if (state->pc == 0) {
+            if (m_event == NUCLEUS_EVENT_STOP) {
                 break;
             }
-            interpreter->step();
+            m_event = NUCLEUS_EVENT_NONE;
         }
-    }
-    if (config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
-        for (Segment* ppu_segment : nucleus.cell.ppu_segments) {
-            if (!ppu_segment->contains(state->pc)) {
+        // Callback finished
+        if (state->pc == 0) {
+            break;
+        }
+        if (recompiled) {
+            // Switch to recompiled functions, which return to the caller
+            EntryPoint entry = nucleus.cell.ppu_dispatch.find(state->pc);
+            if (entry) {
+                const u64 ret = state->lr;
+                entry(state, state->gpr, (f64*)state->fpr);
+                state->pc = ret;
                 continue;
             }
 
-            // Execute function at PC
-            const Function& func = ppu_segment->functions[state->pc];
-
-            std::vector<llvm::GenericValue> arguments;
-            for (size_t i = 0; i < func.type_in.size(); i++) {
-                llvm::GenericValue genValue;
-                switch (func.type_in[i]) {
-                case FUNCTION_IN_INTEGER:
-                    genValue.IntVal = llvm::APInt(64, state->gpr[3+i]);
-                    break;
-                case FUNCTION_IN_FLOAT:
-                    genValue.DoubleVal = state->fpr[1+i]._f64;
-                    break;
-                case FUNCTION_IN_VECTOR:
-                    // TODO
-                    break;
-                }
-                arguments.push_back(genValue);
+            // Code not recompiled: Count calls and back-edges at the end of each block if tiered
+            const u32 branch = interpreter->runBlock();
+            if (tiered && branch) {
+                const Instruction code = { nucleus.memory.read32(branch) };
+                nucleus.cell.ppu_tiering.profile(branch, state->pc, code.is_call());
             }
+        }
+        else if (config.ppuBlockDispatch) {
+            interpreter->runBlock();
+        }
+        else {
+            interpreter->step();
+        }
+    }
+}
 
-            llvm::ExecutionEngine* ee = ppu_segment->executionEngine;
-            llvm::GenericValue ret = ee->runFunction(func.function, arguments);
+void Thread::interpret(u32 addr, u64* gpr, f64* fpr)
+{
+    for (int i = 3; i <= 10; i++) {
+        state->gpr[i] = gpr[i];
+    }
+    for (int i = 1; i <= 13; i++) {
+        state->fpr[i]._f64 = fpr[i];
+    }
+
+    // Returning to address 0 finishes the call, as with callbacks
+    const u64 savedLr = state->lr;
+    state->lr = 0;
+    interpretFrom(addr);
+    state->lr = savedLr;
+
+    gpr[3] = state->gpr[3];
+    fpr[1] = state->fpr[1]._f64;
+}
 
-            switch (func.type_out) {
-            case FUNCTION_OUT_INTEGER:
-                state->gpr[3] = *ret.IntVal.getRawData();
-            case FUNCTION_OUT_FLOAT:
-                state->fpr[1]._f64 = ret.DoubleVal;
-            default:
-                // TODO
+void Thread::interpretInstruction(u32 addr)
+{
+    const u32 savedPc = state->pc;
+    state->pc = addr;
+    interpreter->step();
+    state->pc = savedPc;
+}
+
+void Thread::interpretFrom(u32 addr)
+{
+    const u32 savedPc = state->pc;
+    state->pc = addr;
+
+    // Calls and returns are counted, so that the interpreter stops once the function it resumed returns
+    s32 depth = 0;
+    while (state->pc != 0) {
+        EntryPoint entry = nucleus.cell.ppu_dispatch.find(state->pc);
+        if (entry) {
+            // Recompiled functions return to the caller, as a return instruction would
+            const u64 ret = state->lr;
+            entry(state, state->gpr, (f64*)state->fpr);
+            if (depth-- == 0) {
                 break;
             }
+            state->pc = ret;
+            continue;
+        }
+
+        const u32 branch = interpreter->runBlock();
+        if (!branch || state->pc == branch + 4) {
+            continue;
+        }
+        const Instruction code = { nucleus.memory.read32(branch) };
+        if (code.is_return() && !code.lk) {
+            if (depth-- == 0) {
+                break;
+            }
+        }
+        else if (code.lk && code.is_branch()) {
+            depth += 1;
         }
     }
+    state->pc = savedPc;
 }
 
 void Thread::run()
@@ -173,6 +220,7 @@ void Thread::stop()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_event = NUCLEUS_EVENT_STOP;
+    m_cv.notify_one();
 }
 
 }  // namespace ppu
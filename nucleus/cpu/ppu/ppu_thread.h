@@ -32,6 +32,17 @@ public:
     virtual void start() override;
     virtual void task() override;
 
+    // Interpret the function at the specified address until it returns, passing the argument
+    // registers through the arrays (used by recompiled code calling functions not recompiled)
+    void interpret(u32 addr, u64* gpr, f64* fpr);
+
+    // Execute the instruction at the specified address with the interpreter
+    void interpretInstruction(u32 addr);
+
+    // Resume the interpreter at the specified address until the function containing it returns
+    // (or it reaches address 0), entering the recompiled functions it reaches
+    void interpretFrom(u32 addr);
+
     // Control the thread once it is started
     virtual void run() override;
     virtual void pause() override;
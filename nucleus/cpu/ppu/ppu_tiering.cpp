@@ -0,0 +1,107 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "ppu_tiering.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_decoder.h"
+
+#include <algorithm>
+
+namespace cpu {
+namespace ppu {
+
+Tiering::~Tiering()
+{
+    close();
+}
+
+void Tiering::init(u32 threshold)
+{
+    m_threshold = std::max(threshold, 1U);
+    m_running = true;
+    m_thread = std::thread([this]() {
+        while (true) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [&]{ return !m_queue.empty() || !m_running; });
+            if (!m_running) {
+                break;
+            }
+            const Request request = m_queue.front();
+            m_queue.pop();
+            lock.unlock();
+            compile(request);
+        }
+    });
+}
+
+void Tiering::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        m_cv.notify_one();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void Tiering::enqueue(u32 addr, bool optimize)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Request request;
+    request.addr = addr;
+    request.optimize = optimize;
+    m_queue.push(request);
+    m_cv.notify_one();
+}
+
+void Tiering::addSegment(Segment* segment)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_segments.push_back(segment);
+}
+
+void Tiering::removeSegment(Segment* segment)
+{
+    std::lock_guard<std::mutex> compileLock(m_compileMutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_segments.erase(std::remove(m_segments.begin(), m_segments.end(), segment), m_segments.end());
+}
+
+void Tiering::compile(const Request& request)
+{
+    std::lock_guard<std::mutex> compileLock(m_compileMutex);
+
+    // Segments might be loaded while compiling
+    std::vector<Segment*> segments;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        segments = m_segments;
+    }
+    for (Segment* segment : segments) {
+        if (!segment->contains(request.addr)) {
+            continue;
+        }
+        if (request.optimize) {
+            segment->optimizeFunction(request.addr);
+        }
+        else {
+            segment->recompileFunction(request.addr);
+        }
+        return;
+    }
+}
+
+/**
+ * Recompiler utilities
+ */
+void ppuTierUp(u32 addr)
+{
+    nucleus.cell.ppu_tiering.optimize(addr);
+}
+
+}  // namespace ppu
+}  // namespace cpu
@@ -0,0 +1,93 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+#include "nucleus/cpu/ppu/ppu_dispatch.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace cpu {
+namespace ppu {
+
+// Class declarations
+class Segment;
+
+/**
+ * Tiered translator:
+ * Threads start running in the interpreter, which counts the calls to each function and the
+ * back-edges of each loop. Once one of these counters reaches the threshold, the function containing
+ * its target is queued for recompilation on a background thread. Its entry point is then published
+ * in the dispatch table, so the interpreter switches to the recompiled code at the next call.
+ * This first recompilation is profiled: Functions count the executions of their blocks and branches.
+ * Functions whose entry count reaches the second threshold are recompiled again, optimized with
+ * the collected profile.
+ */
+class Tiering
+{
+    // Number of calls or back-edges to each function entry or loop header
+    AddressTable<u32> m_counters;
+    u32 m_threshold = 0;
+
+    // Background compiler
+    struct Request {
+        u32 addr;
+        bool optimize;  // Request the profile-guided recompilation of a profiled function
+    };
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::queue<Request> m_queue;
+    std::vector<Segment*> m_segments;
+    bool m_running = false;
+
+    // Held while compiling, so that segments are not removed during a recompilation
+    std::mutex m_compileMutex;
+
+    void enqueue(u32 addr, bool optimize);
+    void compile(const Request& request);
+
+public:
+    ~Tiering();
+
+    void init(u32 threshold);
+    void close();
+
+    // Register an analyzed segment whose functions can be recompiled
+    void addSegment(Segment* segment);
+
+    // Unregister a segment, waiting for any recompilation in progress
+    void removeSegment(Segment* segment);
+
+    // Queue the profile-guided recompilation of a profiled function
+    void optimize(u32 addr) {
+        enqueue(addr, true);
+    }
+
+    // Count a branch taken by the interpreter, queueing its target once it gets hot
+    void profile(u32 from, u32 to, bool call) {
+        if (!call && to > from) {
+            return;
+        }
+        if (m_counters.at(to).fetch_add(1, std::memory_order_relaxed) + 1 == m_threshold) {
+            enqueue(to, false);
+        }
+    }
+};
+
+/**
+ * Recompiler utilities:
+ * Called by profiled functions once they stay hot.
+ */
+void ppuTierUp(u32 addr);
+
+}  // namespace ppu
+}  // namespace cpu
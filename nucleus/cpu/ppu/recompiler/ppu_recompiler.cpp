@@ -4,7 +4,24 @@
  */
 
 #include "ppu_recompiler.h"
+#include "nucleus/config.h"
 #include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_dispatch.h"
+#include "nucleus/cpu/ppu/ppu_spin.h"
+#include "nucleus/cpu/ppu/ppu_state.h"
+
+#include "llvm/Config/llvm-config.h"
+
+#include <cstddef>
+#if defined(NUCLEUS_ARCH_X86_64)
+#if defined(NUCLEUS_COMPILER_MSVC)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#include <algorithm>
 
 namespace cpu {
 namespace ppu {
@@ -34,10 +51,39 @@ const char* string_vr[] = {
 const char* string_cr = "cr_";
 const char* string_fpscr = "fpscr_";
 const char* string_xer = "xer_";
+const char* string_ctr = "ctr_";
+const char* string_lr = "lr_";
+
+// Names of the TBAA type nodes of each alias class
+const char* string_alias[] = {
+    "memory", "gpr", "fpr", "vr", "cr", "xer", "ctr", "lr", "fpscr", "vscr",
+};
 
-Recompiler::Recompiler(Segment* segment, Function* function) :
-    builder(llvm::getGlobalContext()),
+// Generated code targets the host CPU: Check for the extensions used explicitly
+static bool hostHasSSSE3()
+{
+#if defined(NUCLEUS_ARCH_X86_64)
+    // CPUID.01H:ECX.SSSE3[bit 9]
+#if defined(NUCLEUS_COMPILER_MSVC)
+    int info[4];
+    __cpuid(info, 1);
+    const u32 ecx = info[2];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+#endif
+    return (ecx & (1 << 9)) != 0;
+#else
+    return false;
+#endif
+}
+
+Recompiler::Recompiler(Segment* segment, Partition* partition, Function* function) :
+    builder(*partition->context),
     segment(segment),
+    partition(partition),
     function(function)
 {
 }
@@ -61,26 +107,25 @@ void Recompiler::createReturn()
         ret = getGPR(3);
         break;
     case FUNCTION_OUT_FLOAT:
-        ret = getFPR(1);
-        break;
     case FUNCTION_OUT_FLOAT_X2:
-        ret = getFPR(1); // TODO
-        break;
     case FUNCTION_OUT_FLOAT_X3:
-        ret = getFPR(1); // TODO
-        break;
     case FUNCTION_OUT_FLOAT_X4:
-        ret = getFPR(1); // TODO
+        // Results on f2:f4 are spilled into the thread state before returning, like any other register
+        ret = getFPR(1);
         break;
     case FUNCTION_OUT_VECTOR:
-        ret = getVR_u32(2);
+        ret = getVR_u128(2);
         break;
     }
 
+    if (config.ppuInstrumentation == PPU_INSTRUMENTATION_PROFILE) {
+        createProfileExit();
+    }
+
     if (returnType == FUNCTION_OUT_VOID) {
-        builder.CreateRetVoid();
+        returns.push_back(builder.CreateRetVoid());
     } else {
-        builder.CreateRet(ret);
+        returns.push_back(builder.CreateRet(ret));
     }
 }
 
@@ -90,8 +135,14 @@ void Recompiler::createProlog()
     llvm::BasicBlock* prologBlock = function->prolog;
     builder.SetInsertPoint(prologBlock);
 
-    // Place arguments in local variables
+    // Arguments of the calling convention
     auto argValue = function->function->arg_begin();
+    state = argValue++;
+    state->setName("state");
+    memoryBase = argValue++;
+    memoryBase->setName("memory_base");
+
+    // Place arguments in local variables
     for (int i = 0; i < function->type_in.size(); i++, argValue++) {
         switch (function->type_in[i]) {
         case FUNCTION_IN_INTEGER:
@@ -103,20 +154,327 @@ void Recompiler::createProlog()
             builder.CreateStore(argValue, fpr[1 + i]);
             break;
         case FUNCTION_IN_VECTOR:
-            // TODO
+            setVR(2 + i, argValue);
             break;
         }
     }
 
+    // Get the start-timestamp to profile the function
+    if (config.ppuInstrumentation == PPU_INSTRUMENTATION_PROFILE) {
+        llvm::Function* readCycleCounter = llvm::Intrinsic::getDeclaration(partition->module, llvm::Intrinsic::readcyclecounter);
+        profileChildCycles = builder.CreateCall(partition->module->getFunction("ppuProfileEnter"));
+        profileStart = builder.CreateCall(readCycleCounter);
+    }
+
     // Print name of the function and registers r3 to r10
-    std::string functionInfo = function->name + "\nr3  = %016llX\nr4  = %016llX\nr5  = %016llX\nr6  = %016llX\nr7  = %016llX\nr8  = %016llX\nr9  = %016llX\nr10 = %016llX\n\n";
-    emit_printf(functionInfo.c_str(), std::vector<llvm::Value*>{
-        getGPR(3), getGPR(4), getGPR(5), getGPR(6), getGPR(7), getGPR(8), getGPR(9), getGPR(10)
-    });
+    if (config.ppuInstrumentation == PPU_INSTRUMENTATION_TRACE) {
+        std::string functionInfo = function->name + "\nr3  = %016llX\nr4  = %016llX\nr5  = %016llX\nr6  = %016llX\nr7  = %016llX\nr8  = %016llX\nr9  = %016llX\nr10 = %016llX\n\n";
+        emit_printf(functionInfo.c_str(), std::vector<llvm::Value*>{
+            getGPR(3), getGPR(4), getGPR(5), getGPR(6), getGPR(7), getGPR(8), getGPR(9), getGPR(10)
+        });
+    }
 
     // Branch to the real entry block
-    llvm::BasicBlock* entryBlock = function->blocks[function->address].bb;
-    builder.CreateBr(entryBlock);
+    const Block& entry = function->blocks[function->address];
+
+    // Profiled functions request their optimization once they get hot, only once even if the counter
+    // skips the threshold due to lost increments
+    if (partition->profiled) {
+        u64* entryCounter = &function->counters[2 * entry.index];
+        llvm::Value* addr = builder.CreateIntToPtr(builder.getInt64((u64)entryCounter), builder.getInt64Ty()->getPointerTo());
+        llvm::Value* requested = builder.CreateIntToPtr(builder.getInt64((u64)&function->tierUpRequested), builder.getInt8PtrTy());
+        llvm::Value* isHot = builder.CreateICmpUGE(builder.CreateLoad(addr), builder.getInt64(config.ppuTier2Threshold));
+        isHot = builder.CreateAnd(isHot, builder.CreateICmpEQ(builder.CreateLoad(requested), builder.getInt8(0)));
+        llvm::BasicBlock* tierUpBlock = llvm::BasicBlock::Create(builder.getContext(), "tier_up", function->function);
+        llvm::MDNode* weights = llvm::MDBuilder(builder.getContext()).createBranchWeights(1, 2000);
+        builder.CreateCondBr(isHot, tierUpBlock, entry.bb, weights);
+        builder.SetInsertPoint(tierUpBlock);
+        builder.CreateStore(builder.getInt8(1), requested);
+        builder.CreateCall(partition->module->getFunction("ppuTierUp"), builder.getInt32(function->address));
+    }
+    builder.CreateBr(entry.bb);
+}
+
+void Recompiler::createProfileExit()
+{
+    llvm::Function* readCycleCounter = llvm::Intrinsic::getDeclaration(partition->module, llvm::Intrinsic::readcyclecounter);
+    llvm::Value* cycles = builder.CreateSub(builder.CreateCall(readCycleCounter), profileStart);
+    builder.CreateCall(partition->module->getFunction("ppuProfileExit"), std::vector<llvm::Value*>{
+        builder.getInt32(function->address), builder.getInt32(function->tier), cycles, profileChildCycles
+    });
+}
+
+void Recompiler::createBlockCounter(u64* counters)
+{
+    blockCounters = counters;
+    if (partition->profiled) {
+        createCounter(&blockCounters[0]);
+    }
+}
+
+void Recompiler::createCounter(u64* counter, llvm::Value* value)
+{
+    llvm::Value* addr = builder.CreateIntToPtr(builder.getInt64((u64)counter), builder.getInt64Ty()->getPointerTo());
+    llvm::Value* increment = value ? builder.CreateZExt(value, builder.getInt64Ty()) : builder.getInt64(1);
+
+    // Counters are not updated atomically: Lost increments only make the profile slightly less accurate
+    builder.CreateStore(builder.CreateAdd(builder.CreateLoad(addr), increment), addr);
+}
+
+llvm::MDNode* Recompiler::getBranchWeights(Instruction code, u32 target)
+{
+    llvm::MDBuilder mdBuilder(builder.getContext());
+
+    // Profile collected by the previous code of the function
+    if (partition->optimized && blockCounters && blockCounters[0]) {
+        u64 taken = std::min(blockCounters[1], blockCounters[0]);
+        u64 notTaken = blockCounters[0] - taken;
+        while ((taken | notTaken) >> 31) {
+            taken >>= 1;
+            notTaken >>= 1;
+        }
+        return mdBuilder.createBranchWeights(taken + 1, notTaken + 1);
+    }
+
+    // Static prediction: Backward branches are taken and forward branches are not, unless the "y" bit of BO is set
+    const bool backward = (target <= currentAddress);
+    const bool predictTaken = backward ^ (code.bo & 0x1);
+    return predictTaken ? mdBuilder.createBranchWeights(64, 4) : mdBuilder.createBranchWeights(4, 64);
+}
+
+void Recompiler::createEntry()
+{
+    llvm::Function* entry = function->entry;
+    builder.SetInsertPoint(llvm::BasicBlock::Create(builder.getContext(), "entry", entry));
+
+    auto argValue = entry->arg_begin();
+    llvm::Value* entryState = argValue++;
+    llvm::Value* gprArray = argValue++;
+    llvm::Value* fprArray = argValue++;
+
+    // Read arguments from the guest registers
+    std::vector<llvm::Value*> arguments;
+    arguments.push_back(entryState);
+    arguments.push_back(builder.CreateIntToPtr(builder.CreateLoad(partition->memoryBase), builder.getInt8PtrTy()));
+    for (int i = 0; i < function->type_in.size(); i++) {
+        switch (function->type_in[i]) {
+        case FUNCTION_IN_INTEGER:
+            arguments.push_back(builder.CreateLoad(builder.CreateConstGEP1_32(gprArray, 3 + i)));
+            break;
+        case FUNCTION_IN_FLOAT:
+            arguments.push_back(builder.CreateLoad(builder.CreateConstGEP1_32(fprArray, 1 + i)));
+            break;
+        case FUNCTION_IN_VECTOR:
+            // Vector registers are only held by the thread state
+            arguments.push_back(builder.CreateAlignedLoad(getEntryState(entryState, offsetof(State, vr) + 16 * (2 + i), builder.getIntNTy(128)), 8));
+            break;
+        }
+    }
+    llvm::CallInst* result = builder.CreateCall(function->function, arguments);
+    result->setCallingConv(FUNCTION_CALLING_CONV);
+
+    // Write return value to the guest registers
+    switch (returnType) {
+    case FUNCTION_OUT_INTEGER:
+        builder.CreateStore(result, builder.CreateConstGEP1_32(gprArray, 3));
+        break;
+    case FUNCTION_OUT_FLOAT:
+        builder.CreateStore(result, builder.CreateConstGEP1_32(fprArray, 1));
+        break;
+    case FUNCTION_OUT_FLOAT_X2:
+    case FUNCTION_OUT_FLOAT_X3:
+    case FUNCTION_OUT_FLOAT_X4:
+        // Only f1 is returned as a value: The other results were spilled into the thread state before returning
+        builder.CreateStore(result, builder.CreateConstGEP1_32(fprArray, 1));
+        for (int i = 2; i <= 2 + returnType - FUNCTION_OUT_FLOAT_X2; i++) {
+            llvm::Value* value = builder.CreateAlignedLoad(getEntryState(entryState, offsetof(State, fpr) + 8 * i, builder.getDoubleTy()), 8);
+            builder.CreateStore(value, builder.CreateConstGEP1_32(fprArray, i));
+        }
+        break;
+    case FUNCTION_OUT_VECTOR:
+        builder.CreateAlignedStore(result, getEntryState(entryState, offsetof(State, vr) + 16 * 2, builder.getIntNTy(128)), 8);
+        break;
+    }
+    builder.CreateRetVoid();
+}
+
+llvm::Value* Recompiler::getEntryState(llvm::Value* entryState, size_t offset, llvm::Type* type)
+{
+    llvm::Value* addr = builder.CreateConstGEP1_32(entryState, offset);
+    return builder.CreateBitCast(addr, type->getPointerTo());
+}
+
+void Recompiler::createInterpreterFallback()
+{
+    llvm::Function* interpretFunc = partition->module->getFunction("ppuInterpretInstruction");
+    interpreterCalls.push_back(builder.CreateCall(interpretFunc, builder.getInt32(currentAddress)));
+}
+
+void Recompiler::createInterpreterExit(u32 target)
+{
+    llvm::Function* interpretFunc = partition->module->getFunction("ppuInterpretFrom");
+    interpreterCalls.push_back(builder.CreateCall(interpretFunc, builder.getInt32(target)));
+    createReturn();
+}
+
+/**
+ * Alias analysis
+ */
+void Recompiler::setAliasClass(llvm::Instruction* access, AliasClass aliasClass)
+{
+    // Nodes are uniqued by the context, so every function of the partition shares the same type tree
+    llvm::MDBuilder mdBuilder(builder.getContext());
+    llvm::MDNode* root = mdBuilder.createTBAARoot("nucleus.ppu");
+    llvm::MDNode* type = mdBuilder.createTBAANode(string_alias[aliasClass], root);
+    access->setMetadata(llvm::LLVMContext::MD_tbaa, mdBuilder.createTBAAStructTagNode(type, type, 0));
+}
+
+llvm::Value* Recompiler::loadState(llvm::IRBuilder<>& stateBuilder, size_t offset, llvm::Type* type, AliasClass aliasClass)
+{
+    llvm::Value* addr = stateBuilder.CreateConstGEP1_32(state, offset);
+    addr = stateBuilder.CreateBitCast(addr, type->getPointerTo());
+
+    // NOTE: Vector registers are stored as u128, with an alignment of 8 bytes
+    llvm::LoadInst* value = stateBuilder.CreateAlignedLoad(addr, std::min<u32>(type->getPrimitiveSizeInBits() / 8, 8));
+    setAliasClass(value, aliasClass);
+    return value;
+}
+
+void Recompiler::storeState(llvm::IRBuilder<>& stateBuilder, size_t offset, llvm::Value* value, AliasClass aliasClass)
+{
+    llvm::Type* type = value->getType();
+    llvm::Value* addr = stateBuilder.CreateConstGEP1_32(state, offset);
+    addr = stateBuilder.CreateBitCast(addr, type->getPointerTo());
+
+    llvm::StoreInst* store = stateBuilder.CreateAlignedStore(value, addr, std::min<u32>(type->getPrimitiveSizeInBits() / 8, 8));
+    setAliasClass(store, aliasClass);
+}
+
+void Recompiler::spillRegisters(llvm::IRBuilder<>& spillBuilder)
+{
+    for (int i = 0; i < 32; i++) {
+        if (gpr[i]) {
+            storeState(spillBuilder, offsetof(State, gpr) + 8 * i, spillBuilder.CreateLoad(gpr[i]), ALIAS_GPR);
+        }
+        if (fpr[i]) {
+            storeState(spillBuilder, offsetof(State, fpr) + 8 * i, spillBuilder.CreateLoad(fpr[i]), ALIAS_FPR);
+        }
+    }
+    for (int i = 0; i < 32; i++) {
+        if (vr[i]) {
+            storeState(spillBuilder, offsetof(State, vr) + 16 * i, spillBuilder.CreateLoad(vr[i]), ALIAS_VR);
+        }
+    }
+    if (ctr) {
+        storeState(spillBuilder, offsetof(State, ctr), spillBuilder.CreateLoad(ctr), ALIAS_CTR);
+    }
+    if (lr) {
+        storeState(spillBuilder, offsetof(State, lr), spillBuilder.CreateLoad(lr), ALIAS_LR);
+    }
+}
+
+void Recompiler::reloadRegisters(llvm::IRBuilder<>& reloadBuilder)
+{
+    for (int i = 0; i < 32; i++) {
+        if (gpr[i]) {
+            reloadBuilder.CreateStore(loadState(reloadBuilder, offsetof(State, gpr) + 8 * i, reloadBuilder.getInt64Ty(), ALIAS_GPR), gpr[i]);
+        }
+        if (fpr[i]) {
+            reloadBuilder.CreateStore(loadState(reloadBuilder, offsetof(State, fpr) + 8 * i, reloadBuilder.getDoubleTy(), ALIAS_FPR), fpr[i]);
+        }
+    }
+    for (int i = 0; i < 32; i++) {
+        if (vr[i]) {
+            reloadBuilder.CreateStore(loadState(reloadBuilder, offsetof(State, vr) + 16 * i, vr[i]->getAllocatedType(), ALIAS_VR), vr[i]);
+        }
+    }
+    if (ctr) {
+        reloadBuilder.CreateStore(loadState(reloadBuilder, offsetof(State, ctr), reloadBuilder.getInt64Ty(), ALIAS_CTR), ctr);
+    }
+    if (lr) {
+        reloadBuilder.CreateStore(loadState(reloadBuilder, offsetof(State, lr), reloadBuilder.getInt64Ty(), ALIAS_LR), lr);
+    }
+}
+
+void Recompiler::createStateSync()
+{
+    llvm::IRBuilder<> prologBuilder(function->prolog->getTerminator());
+
+    // The link register starts with the value held by the thread state, which the interpreter reads
+    // when returning from the function (the interpreter stops by counting calls, not at a fixed address)
+    if (!lr) {
+        lr = allocaVariable(builder.getInt64Ty(), string_lr);
+    }
+    prologBuilder.CreateStore(loadState(prologBuilder, offsetof(State, lr), prologBuilder.getInt64Ty(), ALIAS_LR), lr);
+
+    // Registers not passed as arguments (e.g. r1, r2, r13 and the non-volatile ones) start with the value
+    // held by the thread state, written by the caller or by the interpreter before entering the function
+    std::vector<llvm::AllocaInst*> arguments;
+    for (int i = 0; i < function->type_in.size(); i++) {
+        if (function->type_in[i] == FUNCTION_IN_INTEGER) {
+            arguments.push_back(gpr[3 + i]);
+        }
+        if (function->type_in[i] == FUNCTION_IN_FLOAT) {
+            arguments.push_back(fpr[1 + i]);
+        }
+        if (function->type_in[i] == FUNCTION_IN_VECTOR) {
+            arguments.push_back(vr[2 + i]);
+        }
+    }
+    for (int i = 0; i < 32; i++) {
+        if (gpr[i] && std::find(arguments.begin(), arguments.end(), gpr[i]) == arguments.end()) {
+            prologBuilder.CreateStore(loadState(prologBuilder, offsetof(State, gpr) + 8 * i, prologBuilder.getInt64Ty(), ALIAS_GPR), gpr[i]);
+        }
+        if (fpr[i] && std::find(arguments.begin(), arguments.end(), fpr[i]) == arguments.end()) {
+            prologBuilder.CreateStore(loadState(prologBuilder, offsetof(State, fpr) + 8 * i, prologBuilder.getDoubleTy(), ALIAS_FPR), fpr[i]);
+        }
+        if (vr[i] && std::find(arguments.begin(), arguments.end(), vr[i]) == arguments.end()) {
+            prologBuilder.CreateStore(loadState(prologBuilder, offsetof(State, vr) + 16 * i, vr[i]->getAllocatedType(), ALIAS_VR), vr[i]);
+        }
+    }
+    if (ctr) {
+        prologBuilder.CreateStore(loadState(prologBuilder, offsetof(State, ctr), prologBuilder.getInt64Ty(), ALIAS_CTR), ctr);
+    }
+
+    for (llvm::CallInst* call : interpreterCalls) {
+        llvm::BasicBlock::iterator next = call;
+        llvm::IRBuilder<> spillBuilder(call);
+        llvm::IRBuilder<> reloadBuilder(call->getParent(), ++next);
+        spillRegisters(spillBuilder);
+        reloadRegisters(reloadBuilder);
+    }
+
+    // Callees read the registers they do not receive as arguments from the thread state, and callees
+    // entered through the runtime might be interpreted
+    for (const auto& call : runtimeCalls) {
+        llvm::BasicBlock::iterator next = call.first;
+        llvm::IRBuilder<> spillBuilder(call.first);
+        llvm::IRBuilder<> reloadBuilder(call.second ? call.second : &*++next);
+        spillRegisters(spillBuilder);
+        reloadRegisters(reloadBuilder);
+    }
+
+    // Callers reload their registers from the thread state after calling this function
+    for (llvm::Instruction* ret : returns) {
+        llvm::IRBuilder<> spillBuilder(ret);
+        spillRegisters(spillBuilder);
+    }
+}
+
+void Recompiler::createArgumentAttributes()
+{
+    // Guest memory is only accessed through the memory base, unless the function calls into the runtime
+    // (interpreter, dispatcher or spin loop backoff), which reaches guest memory through other pointers
+    if (hasOpaqueCalls || !interpreterCalls.empty()) {
+        return;
+    }
+    llvm::Function* func = function->function;
+    func->setDoesNotAlias(FUNCTION_ARG_MEMORY_BASE + 1);
+
+    // The memory base is followed by the whole 4 GB guest address space (attribute available since LLVM 3.6)
+#if LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR >= 6
+    func->addDereferenceableAttr(FUNCTION_ARG_MEMORY_BASE + 1, 0x100000000ULL);
+#endif
 }
 
 llvm::AllocaInst* Recompiler::allocaVariable(llvm::Type* type, const llvm::Twine& name)
@@ -175,34 +533,79 @@ void Recompiler::setFPR(int index, llvm::Value* value)
     builder.CreateStore(value, fpr[index]);
 }
 
+llvm::Value* Recompiler::getVR(int index, llvm::Type* type)
+{
+    if (!vr[index]) {
+        vr[index] = allocaVariable(llvm::VectorType::get(builder.getInt32Ty(), 4), string_vr[index]);
+    }
+    llvm::Value* reg = builder.CreateLoad(vr[index], string_vr[index]);
+    return builder.CreateBitCast(reg, type);
+}
+
 llvm::Value* Recompiler::getVR_u8(int index)
 {
-    // TODO: ?
-    return nullptr;
+    return getVR(index, llvm::VectorType::get(builder.getInt8Ty(), 16));
 }
 
 llvm::Value* Recompiler::getVR_u16(int index)
 {
-    // TODO: ?
-    return nullptr;
+    return getVR(index, llvm::VectorType::get(builder.getInt16Ty(), 8));
 }
 
 llvm::Value* Recompiler::getVR_u32(int index)
 {
-    // TODO: ?
-    return nullptr;
+    return getVR(index, llvm::VectorType::get(builder.getInt32Ty(), 4));
 }
 
 llvm::Value* Recompiler::getVR_f32(int index)
 {
-    // TODO: ?
-    return nullptr;
+    return getVR(index, llvm::VectorType::get(builder.getFloatTy(), 4));
+}
+
+llvm::Value* Recompiler::getVR_u128(int index)
+{
+    return getVR(index, builder.getIntNTy(128));
 }
 
 void Recompiler::setVR(int index, llvm::Value* value)
 {
-    // TODO: ?
-    return;
+    llvm::Type* type = llvm::VectorType::get(builder.getInt32Ty(), 4);
+    if (!vr[index]) {
+        vr[index] = allocaVariable(type, string_vr[index]);
+    }
+    builder.CreateStore(builder.CreateBitCast(value, type), vr[index]);
+}
+
+llvm::Value* Recompiler::getCTR()
+{
+    if (!ctr) {
+        ctr = allocaVariable(builder.getInt64Ty(), string_ctr);
+    }
+    return builder.CreateLoad(ctr, string_ctr);
+}
+
+void Recompiler::setCTR(llvm::Value* value)
+{
+    if (!ctr) {
+        ctr = allocaVariable(builder.getInt64Ty(), string_ctr);
+    }
+    builder.CreateStore(value, ctr);
+}
+
+llvm::Value* Recompiler::getLR()
+{
+    if (!lr) {
+        lr = allocaVariable(builder.getInt64Ty(), string_lr);
+    }
+    return builder.CreateLoad(lr, string_lr);
+}
+
+void Recompiler::setLR(llvm::Value* value)
+{
+    if (!lr) {
+        lr = allocaVariable(builder.getInt64Ty(), string_lr);
+    }
+    builder.CreateStore(value, lr);
 }
 
 /**
@@ -214,21 +617,127 @@ void Recompiler::updateCR0(llvm::Value* value)
     llvm::Value* isGT = builder.CreateICmpSGT(value, builder.getInt64(0));
     llvm::Value* cr;
 
-    cr = builder.CreateSelect(isGT, builder.getInt8(2), builder.getInt8(4));
-    cr = builder.CreateSelect(isLT, builder.getInt8(1), cr);
+    cr = builder.CreateSelect(isGT, builder.getInt32(2), builder.getInt32(4));
+    cr = builder.CreateSelect(isLT, builder.getInt32(1), cr);
+    cr = builder.CreateOr(cr, builder.CreateShl(getXERSO(), PPU_CR::CR_SO));
+    setCRField(0, cr);
+}
+
+llvm::Value* Recompiler::getXERSO()
+{
+    llvm::Value* xer = loadState(builder, offsetof(State, xer), builder.getInt64Ty(), ALIAS_XER);
+    xer = builder.CreateAnd(builder.CreateLShr(xer, 31), 1);
+    return builder.CreateTrunc(xer, builder.getInt32Ty());
+}
+
+llvm::Value* Recompiler::getCRBit(u32 bit)
+{
+    const size_t offset = offsetof(State, cr);
+    llvm::Value* cr = loadState(builder, offset + offsetof(PPU_CR, CR), builder.getInt32Ty(), ALIAS_CR);
+    llvm::Value* value = builder.CreateAnd(builder.CreateLShr(cr, bit), 1);
+    value = builder.CreateICmpNE(value, builder.getInt32(0));
+    if (bit >= 4) {
+        return value;
+    }
+
+    // The interpreter might have deferred the computation of field 0 (lazy flags)
+    llvm::Value* pending = loadState(builder, offset + offsetof(PPU_CR, pending), builder.getInt8Ty(), ALIAS_CR);
+    llvm::Value* result = loadState(builder, offset + offsetof(PPU_CR, pendingResult), builder.getInt64Ty(), ALIAS_CR);
+    llvm::Value* pendingValue;
+    switch (bit) {
+    case PPU_CR::CR_LT:
+        pendingValue = builder.CreateICmpSLT(result, builder.getInt64(0));
+        break;
+    case PPU_CR::CR_GT:
+        pendingValue = builder.CreateICmpSGT(result, builder.getInt64(0));
+        break;
+    case PPU_CR::CR_EQ:
+        pendingValue = builder.CreateICmpEQ(result, builder.getInt64(0));
+        break;
+    default:
+        pendingValue = builder.getInt1(false);
+        break;
+    }
+    return builder.CreateSelect(builder.CreateICmpNE(pending, builder.getInt8(0)), pendingValue, value);
+}
+
+llvm::Value* Recompiler::getReservation()
+{
+    return builder.CreateConstGEP1_32(state, offsetof(State, reservation));
+}
+
+void Recompiler::setCRField(u32 field, llvm::Value* value)
+{
+    const size_t offset = offsetof(State, cr);
+    llvm::Value* cr = loadState(builder, offset + offsetof(PPU_CR, CR), builder.getInt32Ty(), ALIAS_CR);
+    cr = builder.CreateAnd(cr, builder.getInt32(~(0xF << (field * 4))));
+    cr = builder.CreateOr(cr, builder.CreateShl(value, field * 4));
+    storeState(builder, offset + offsetof(PPU_CR, CR), cr, ALIAS_CR);
+
+    // Overwrites any field 0 deferred by the interpreter
+    if (field == 0) {
+        storeState(builder, offset + offsetof(PPU_CR, pending), builder.getInt8(0), ALIAS_CR);
+    }
+}
+
+llvm::Value* Recompiler::createBranchCondition(u32 bo, u32 bi)
+{
+    llvm::Value* cond = builder.getInt1(true);
+
+    // BO[2] clear: Decrement CTR, and test whether it reached zero (BO[3] set) or not
+    if (!(bo & 0x04)) {
+        llvm::Value* value = builder.CreateSub(getCTR(), builder.getInt64(1));
+        setCTR(value);
+        cond = (bo & 0x02)
+            ? builder.CreateICmpEQ(value, builder.getInt64(0))
+            : builder.CreateICmpNE(value, builder.getInt64(0));
+    }
+
+    // BO[0] clear: Test whether the CR bit is set (BO[1] set) or clear
+    if (!(bo & 0x10)) {
+        llvm::Value* bit = getCRBit(bi);
+        if (!(bo & 0x08)) {
+            bit = builder.CreateNot(bit);
+        }
+        cond = builder.CreateAnd(cond, bit);
+    }
+    return cond;
+}
+
+void Recompiler::updateSAT(llvm::Value* saturated)
+{
+    // Saturation is rare: Set the sticky bit (VSCR[SAT] is its lowest bit) in the thread state out of line
+    const u32 count = saturated->getType()->getVectorNumElements();
+    llvm::Value* mask = builder.CreateBitCast(saturated, builder.getIntNTy(count));
+    llvm::Value* isSaturated = builder.CreateICmpNE(mask, builder.getIntN(count, 0));
+
+    llvm::BasicBlock* satBlock = llvm::BasicBlock::Create(builder.getContext(), "sat", function->function);
+    llvm::BasicBlock* nextBlock = llvm::BasicBlock::Create(builder.getContext(), "sat_next", function->function);
+    llvm::MDNode* weights = llvm::MDBuilder(builder.getContext()).createBranchWeights(1, 2000);
+    builder.CreateCondBr(isSaturated, satBlock, nextBlock, weights);
+    builder.SetInsertPoint(satBlock);
+    llvm::Value* vscr = loadState(builder, offsetof(State, vscr), builder.getInt32Ty(), ALIAS_VSCR);
+    storeState(builder, offsetof(State, vscr), builder.CreateOr(vscr, builder.getInt32(1)), ALIAS_VSCR);
+    builder.CreateBr(nextBlock);
+    builder.SetInsertPoint(nextBlock);
 }
 
 /**
  * Memory access
  */
+llvm::Value* Recompiler::getMemoryPointer(llvm::Value* addr, llvm::Type* type)
+{
+    llvm::Value* ptr = builder.CreateGEP(memoryBase, addr);
+    return builder.CreateBitCast(ptr, type->getPointerTo());
+}
+
 llvm::Value* Recompiler::readMemory(llvm::Value* addr, int bits)
 {
-    llvm::Value* baseAddr = builder.CreateLoad(segment->memoryBase, false);
     llvm::Value* value;
 
-    addr = builder.CreateAdd(addr, baseAddr);
-    addr = builder.CreateIntToPtr(addr, builder.getIntNTy(bits)->getPointerTo());
+    addr = getMemoryPointer(addr, builder.getIntNTy(bits));
     value = builder.CreateLoad(addr);
+    setAliasClass(llvm::cast<llvm::Instruction>(value), ALIAS_MEMORY);
 
     // Reverse endianness if necessary
     if (bits > 8) {
@@ -241,8 +750,6 @@ llvm::Value* Recompiler::readMemory(llvm::Value* addr, int bits)
 
 void Recompiler::writeMemory(llvm::Value* addr, llvm::Value* value)
 {
-    llvm::Value* baseAddr = builder.CreateLoad(segment->memoryBase, false);
-
     // Reverse endianness if necessary
     int bits = value->getType()->getIntegerBitWidth();
     if (bits > 8) {
@@ -250,19 +757,418 @@ void Recompiler::writeMemory(llvm::Value* addr, llvm::Value* value)
         value = builder.CreateCall(bswap, value);
     }
 
-    addr = builder.CreateAdd(addr, baseAddr);
-    addr = builder.CreateIntToPtr(addr, builder.getIntNTy(bits)->getPointerTo());
-    builder.CreateStore(value, addr);
+    addr = getMemoryPointer(addr, builder.getIntNTy(bits));
+    setAliasClass(builder.CreateStore(value, addr), ALIAS_MEMORY);
+}
+
+llvm::Value* Recompiler::readMemoryVector(llvm::Value* addr)
+{
+    llvm::Type* type = llvm::VectorType::get(builder.getInt8Ty(), 16);
+
+    addr = getMemoryPointer(addr, type);
+    llvm::LoadInst* value = builder.CreateAlignedLoad(addr, 16);
+    setAliasClass(value, ALIAS_MEMORY);
+
+    // Reverse the bytes, which the host does with a single shuffle (pshufb)
+    std::vector<u32> reverse;
+    for (u32 i = 0; i < 16; i++) {
+        reverse.push_back(15 - i);
+    }
+    return builder.CreateShuffleVector(value, llvm::UndefValue::get(type), getShuffleMask(reverse));
+}
+
+void Recompiler::writeMemoryVector(llvm::Value* addr, llvm::Value* value)
+{
+    llvm::Type* type = llvm::VectorType::get(builder.getInt8Ty(), 16);
+
+    std::vector<u32> reverse;
+    for (u32 i = 0; i < 16; i++) {
+        reverse.push_back(15 - i);
+    }
+    value = builder.CreateBitCast(value, type);
+    value = builder.CreateShuffleVector(value, llvm::UndefValue::get(type), getShuffleMask(reverse));
+
+    addr = getMemoryPointer(addr, type);
+    setAliasClass(builder.CreateAlignedStore(value, addr, 16), ALIAS_MEMORY);
+}
+
+/**
+ * Vector operations
+ */
+llvm::Value* Recompiler::getVectorAddress(Instruction code)
+{
+    llvm::Value* addr = getGPR(code.rb);
+    if (code.ra) {
+        addr = builder.CreateAdd(getGPR(code.ra), addr);
+    }
+    return builder.CreateAnd(addr, builder.getInt64(0xFFFFFFFF));
+}
+
+llvm::Value* Recompiler::createVectorPermute(llvm::Value* va, llvm::Value* vb, llvm::Value* vc)
+{
+    // Bytes of vD are taken from vA:vB in guest order, i.e. from vB:vA in host order, where
+    // the index of the host byte selected by each guest index i is 31-i, that is ~i & 0x1F
+    llvm::Type* type = llvm::VectorType::get(builder.getInt8Ty(), 16);
+    if (llvm::Constant* control = llvm::dyn_cast<llvm::Constant>(vc)) {
+        std::vector<llvm::Constant*> mask;
+        for (u32 b = 0; b < 16; b++) {
+            llvm::ConstantInt* index = llvm::dyn_cast_or_null<llvm::ConstantInt>(control->getAggregateElement(b));
+            if (!index) {
+                mask.clear();
+                break;
+            }
+            mask.push_back(builder.getInt32(~index->getZExtValue() & 0x1F));
+        }
+        if (!mask.empty()) {
+            return builder.CreateShuffleVector(vb, va, llvm::ConstantVector::get(mask));
+        }
+    }
+
+    llvm::Value* index = builder.CreateAnd(builder.CreateNot(vc), llvm::ConstantInt::get(type, 0x1F));
+    if (hostHasSSSE3()) {
+        // Shuffle each source with the low bits of the index, and select the source with its bit 4
+        llvm::Function* pshufb = llvm::Intrinsic::getDeclaration(partition->module, llvm::Intrinsic::x86_ssse3_pshuf_b_128);
+        llvm::Value* lo = builder.CreateCall2(pshufb, vb, index);
+        llvm::Value* hi = builder.CreateCall2(pshufb, va, index);
+        llvm::Value* isHigh = builder.CreateICmpNE(builder.CreateAnd(index, llvm::ConstantInt::get(type, 0x10)), llvm::ConstantInt::get(type, 0));
+        return builder.CreateSelect(isHigh, hi, lo);
+    }
+
+    // Generic lowering: Extract each byte from the concatenation of both sources
+    std::vector<u32> concat;
+    for (u32 i = 0; i < 32; i++) {
+        concat.push_back(i);
+    }
+    llvm::Value* source = builder.CreateShuffleVector(vb, va, getShuffleMask(concat));
+    llvm::Value* vd = llvm::UndefValue::get(type);
+    for (u32 b = 0; b < 16; b++) {
+        llvm::Value* byte = builder.CreateExtractElement(source, builder.CreateExtractElement(index, builder.getInt32(b)));
+        vd = builder.CreateInsertElement(vd, byte, builder.getInt32(b));
+    }
+    return vd;
+}
+
+llvm::Value* Recompiler::createSaturatingAdd(llvm::Value* va, llvm::Value* vb, bool isSigned)
+{
+    return createSaturation(va, vb, isSigned, false);
+}
+
+llvm::Value* Recompiler::createSaturatingSub(llvm::Value* va, llvm::Value* vb, bool isSigned)
+{
+    return createSaturation(va, vb, isSigned, true);
+}
+
+llvm::Value* Recompiler::createSaturation(llvm::Value* va, llvm::Value* vb, bool isSigned, bool isSub)
+{
+    llvm::VectorType* type = llvm::cast<llvm::VectorType>(va->getType());
+    const u32 bits = type->getScalarSizeInBits();
+    const u32 count = type->getNumElements();
+
+    llvm::Value* modular = isSub ? builder.CreateSub(va, vb) : builder.CreateAdd(va, vb);
+    llvm::Value* vd;
+#if defined(NUCLEUS_ARCH_X86_64)
+    // SSE2 provides saturating arithmetic on bytes and halfwords: [isSub][isSigned][isHalfword]
+    static const llvm::Intrinsic::ID intrinsics[2][2][2] = {
+        { { llvm::Intrinsic::x86_sse2_paddus_b, llvm::Intrinsic::x86_sse2_paddus_w },
+          { llvm::Intrinsic::x86_sse2_padds_b,  llvm::Intrinsic::x86_sse2_padds_w  } },
+        { { llvm::Intrinsic::x86_sse2_psubus_b, llvm::Intrinsic::x86_sse2_psubus_w },
+          { llvm::Intrinsic::x86_sse2_psubs_b,  llvm::Intrinsic::x86_sse2_psubs_w  } },
+    };
+    if (bits == 8 || bits == 16) {
+        llvm::Function* intrinsic = llvm::Intrinsic::getDeclaration(partition->module, intrinsics[isSub][isSigned][bits == 16]);
+        vd = builder.CreateCall2(intrinsic, va, vb);
+    }
+    else
+#endif
+    {
+        // Compute the exact result with lanes of twice the width, and clamp it
+        llvm::Type* wideType = llvm::VectorType::get(builder.getIntNTy(2 * bits), count);
+        llvm::Value* wa = isSigned ? builder.CreateSExt(va, wideType) : builder.CreateZExt(va, wideType);
+        llvm::Value* wb = isSigned ? builder.CreateSExt(vb, wideType) : builder.CreateZExt(vb, wideType);
+        llvm::Value* result = isSub ? builder.CreateSub(wa, wb) : builder.CreateAdd(wa, wb);
+
+        const llvm::APInt min = isSigned ? llvm::APInt::getSignedMinValue(bits).sext(2 * bits) : llvm::APInt(2 * bits, 0);
+        const llvm::APInt max = isSigned ? llvm::APInt::getSignedMaxValue(bits).sext(2 * bits) : llvm::APInt::getMaxValue(bits).zext(2 * bits);
+        llvm::Value* minValue = llvm::ConstantInt::get(wideType, min);
+        llvm::Value* maxValue = llvm::ConstantInt::get(wideType, max);
+        result = builder.CreateSelect(builder.CreateICmpSLT(result, minValue), minValue, result);
+        result = builder.CreateSelect(builder.CreateICmpSGT(result, maxValue), maxValue, result);
+        vd = builder.CreateTrunc(result, type);
+    }
+
+    // Saturated lanes always differ from the modular result
+    updateSAT(builder.CreateICmpNE(vd, modular));
+    return vd;
+}
+
+llvm::Value* Recompiler::createAverage(llvm::Value* va, llvm::Value* vb, bool isSigned)
+{
+    llvm::VectorType* type = llvm::cast<llvm::VectorType>(va->getType());
+    llvm::Type* wideType = llvm::VectorType::get(builder.getIntNTy(2 * type->getScalarSizeInBits()), type->getNumElements());
+
+    llvm::Value* wa = isSigned ? builder.CreateSExt(va, wideType) : builder.CreateZExt(va, wideType);
+    llvm::Value* wb = isSigned ? builder.CreateSExt(vb, wideType) : builder.CreateZExt(vb, wideType);
+    llvm::Value* sum = builder.CreateAdd(builder.CreateAdd(wa, wb), llvm::ConstantInt::get(wideType, 1));
+    sum = isSigned ? builder.CreateAShr(sum, 1) : builder.CreateLShr(sum, 1);
+    return builder.CreateTrunc(sum, type);
+}
+
+llvm::Value* Recompiler::createMerge(llvm::Value* va, llvm::Value* vb, bool high)
+{
+    // Guest element i is host lane n-1-i: Lanes of vA and vB alternate from the top of vD
+    const u32 n = va->getType()->getVectorNumElements();
+    const u32 first = high ? n - 1 : n / 2 - 1;
+    std::vector<u32> mask(n);
+    for (u32 i = 0; i < n / 2; i++) {
+        mask[n - 1 - 2 * i] = first - i;
+        mask[n - 2 - 2 * i] = n + first - i;
+    }
+    return builder.CreateShuffleVector(va, vb, getShuffleMask(mask));
+}
+
+llvm::Value* Recompiler::createSplat(llvm::Value* vb, u32 element)
+{
+    const u32 n = vb->getType()->getVectorNumElements();
+    std::vector<u32> mask(n, n - 1 - (element & (n - 1)));
+    return builder.CreateShuffleVector(vb, llvm::UndefValue::get(vb->getType()), getShuffleMask(mask));
+}
+
+llvm::Constant* Recompiler::getShuffleMask(const std::vector<u32>& mask)
+{
+    return llvm::ConstantDataVector::get(builder.getContext(), mask);
+}
+
+llvm::Value* Recompiler::getFunction(Function& target)
+{
+    // Profiled functions call each other through the function table, so they reach the optimized code of their callees
+    if (target.partition == function->partition && !partition->profiled) {
+        return target.function;
+    }
+
+    // Functions of other partitions are linked once all of them are compiled
+    llvm::Value* entry = builder.CreateConstGEP2_32(partition->functionTable, 0, target.index);
+    llvm::Value* addr = builder.CreateLoad(entry);
+    llvm::Type* type = target.getType(*partition->context)->getPointerTo();
+    return builder.CreateIntToPtr(addr, type);
+}
+
+llvm::Value* Recompiler::createCall(Function& target, const std::vector<llvm::Value*>& guestArgs)
+{
+    std::vector<llvm::Value*> arguments;
+    arguments.push_back(state);
+    arguments.push_back(memoryBase);
+    arguments.insert(arguments.end(), guestArgs.begin(), guestArgs.end());
+
+    llvm::CallInst* call = builder.CreateCall(getFunction(target), arguments);
+    call->setCallingConv(FUNCTION_CALLING_CONV);
+    return call;
+}
+
+void Recompiler::storeArguments(llvm::Value*& gprArray, llvm::Value*& fprArray)
+{
+    llvm::AllocaInst* gprAlloca = allocaVariable(llvm::ArrayType::get(builder.getInt64Ty(), 32), "gpr_array");
+    llvm::AllocaInst* fprAlloca = allocaVariable(llvm::ArrayType::get(builder.getDoubleTy(), 32), "fpr_array");
+    for (int i = 3; i <= 10; i++) {
+        builder.CreateStore(getGPR(i), builder.CreateConstGEP2_32(gprAlloca, 0, i));
+    }
+    for (int i = 1; i <= 13; i++) {
+        builder.CreateStore(getFPR(i), builder.CreateConstGEP2_32(fprAlloca, 0, i));
+    }
+    gprArray = builder.CreateConstGEP2_32(gprAlloca, 0, 0);
+    fprArray = builder.CreateConstGEP2_32(fprAlloca, 0, 0);
+}
+
+llvm::Instruction* Recompiler::loadResults(llvm::Value* gprArray, llvm::Value* fprArray)
+{
+    // Returns the first instruction emitted, before which the remaining registers can be reloaded
+    llvm::LoadInst* gprResult = builder.CreateLoad(builder.CreateConstGEP1_32(gprArray, 3));
+    llvm::LoadInst* fprResult = builder.CreateLoad(builder.CreateConstGEP1_32(fprArray, 1));
+    setGPR(3, gprResult);
+    setFPR(1, fprResult);
+    llvm::Instruction* first = gprResult;
+    if (auto* gep = llvm::dyn_cast<llvm::Instruction>(gprResult->getPointerOperand())) {
+        first = gep;
+    }
+    return first;
+}
+
+void Recompiler::createDispatch(u32 target)
+{
+    llvm::Function* dispatchFunc = partition->module->getFunction("ppuDispatch");
+
+    // The callee type is unknown: Pass all argument registers and read back all return registers
+    llvm::Value* gprArray;
+    llvm::Value* fprArray;
+    storeArguments(gprArray, fprArray);
+    hasOpaqueCalls = true;
+    llvm::CallInst* call = builder.CreateCall(dispatchFunc, std::vector<llvm::Value*>{ state, builder.getInt32(target), gprArray, fprArray });
+    llvm::Instruction* results = loadResults(gprArray, fprArray);
+    runtimeCalls.push_back(std::make_pair(call, results));
+}
+
+void Recompiler::createIndirectCall()
+{
+    llvm::LLVMContext& context = builder.getContext();
+    llvm::Function* indirectCallFunc = partition->module->getFunction("ppuIndirectCall");
+
+    // Inline cache of this site, defined in the module so that cached objects remain valid
+    llvm::Type* targetsType = llvm::ArrayType::get(builder.getInt32Ty(), InlineCache::ENTRIES);
+    llvm::Type* slotsType = llvm::ArrayType::get(builder.getInt64Ty(), InlineCache::ENTRIES);
+    llvm::StructType* cacheType = llvm::StructType::get(context, std::vector<llvm::Type*>{ targetsType, slotsType });
+    llvm::GlobalVariable* cache = new llvm::GlobalVariable(*partition->module, cacheType, false,
+        llvm::GlobalValue::InternalLinkage, llvm::ConstantAggregateZero::get(cacheType), format("ic_%X", currentAddress));
+
+    llvm::Value* target = builder.CreateAnd(getCTR(), builder.getInt64(~0x3ULL));
+    target = builder.CreateTrunc(target, builder.getInt32Ty());
+    llvm::Value* gprArray;
+    llvm::Value* fprArray;
+    storeArguments(gprArray, fprArray);
+
+    // Check each entry of the cache, calling the current code of the target on hits
+    std::vector<llvm::Type*> entryArgs = { builder.getInt8PtrTy(), builder.getInt64Ty()->getPointerTo(), builder.getDoubleTy()->getPointerTo() };
+    llvm::Type* entryType = llvm::FunctionType::get(builder.getVoidTy(), entryArgs, false)->getPointerTo();
+    llvm::BasicBlock* doneBlock = llvm::BasicBlock::Create(context, "ic_done", function->function);
+    for (u32 i = 0; i < InlineCache::ENTRIES; i++) {
+        llvm::BasicBlock* checkBlock = llvm::BasicBlock::Create(context, "ic_check", function->function);
+        llvm::BasicBlock* slotBlock = llvm::BasicBlock::Create(context, "ic_slot", function->function);
+        llvm::BasicBlock* callBlock = llvm::BasicBlock::Create(context, "ic_call", function->function);
+        llvm::BasicBlock* nextBlock = llvm::BasicBlock::Create(context, "ic_next", function->function);
+
+        llvm::LoadInst* cachedTarget = builder.CreateLoad(builder.CreateGEP(cache, std::vector<llvm::Value*>{
+            builder.getInt32(0), builder.getInt32(0), builder.getInt32(i) }));
+        cachedTarget->setAtomic(llvm::Acquire);
+        cachedTarget->setAlignment(4);
+        builder.CreateCondBr(builder.CreateICmpEQ(cachedTarget, target), checkBlock, nextBlock);
+
+        // Free entries hold the target 0 along with a null slot, so jumps to 0 must not use them
+        builder.SetInsertPoint(checkBlock);
+        llvm::Value* slot = builder.CreateLoad(builder.CreateGEP(cache, std::vector<llvm::Value*>{
+            builder.getInt32(0), builder.getInt32(1), builder.getInt32(i) }));
+        builder.CreateCondBr(builder.CreateICmpNE(slot, builder.getInt64(0)), slotBlock, nextBlock);
+
+        // Entries are published after their slot, but slots might be empty while the target is recompiled
+        builder.SetInsertPoint(slotBlock);
+        slot = builder.CreateIntToPtr(slot, builder.getInt64Ty()->getPointerTo());
+        llvm::LoadInst* entry = builder.CreateLoad(slot);
+        entry->setAtomic(llvm::Acquire);
+        entry->setAlignment(8);
+        builder.CreateCondBr(builder.CreateICmpNE(entry, builder.getInt64(0)), callBlock, nextBlock);
+
+        builder.SetInsertPoint(callBlock);
+        builder.CreateCall(builder.CreateIntToPtr(entry, entryType), std::vector<llvm::Value*>{ state, gprArray, fprArray });
+        builder.CreateBr(doneBlock);
+
+        builder.SetInsertPoint(nextBlock);
+    }
+
+    // Cache miss: Resolve the target through the runtime
+    hasOpaqueCalls = true;
+    llvm::Value* cachePtr = builder.CreateBitCast(cache, builder.getInt8PtrTy());
+    builder.CreateCall(indirectCallFunc, std::vector<llvm::Value*>{ state, cachePtr, target, gprArray, fprArray });
+    builder.CreateBr(doneBlock);
+
+    builder.SetInsertPoint(doneBlock);
+    llvm::Instruction* results = loadResults(gprArray, fprArray);
+    runtimeCalls.push_back(std::make_pair(llvm::cast<llvm::Instruction>(gprArray), results));
+}
+
+void Recompiler::createImportCall(u32 stub)
+{
+    llvm::LLVMContext& context = builder.getContext();
+    llvm::Function* dispatchFunc = partition->module->getFunction("ppuDispatch");
+    const u32 index = segment->importStubs.at(stub);
+
+    llvm::Value* gprArray;
+    llvm::Value* fprArray;
+    storeArguments(gprArray, fprArray);
+
+    llvm::BasicBlock* linkedBlock = llvm::BasicBlock::Create(context, "import_linked", function->function);
+    llvm::BasicBlock* stubBlock = llvm::BasicBlock::Create(context, "import_stub", function->function);
+    llvm::BasicBlock* doneBlock = llvm::BasicBlock::Create(context, "import_done", function->function);
+    llvm::LoadInst* entry = builder.CreateLoad(builder.CreateGEP(partition->importLinks, std::vector<llvm::Value*>{
+        builder.getInt32(0), builder.getInt32(index), builder.getInt32(0) }));
+    entry->setAtomic(llvm::Acquire);
+    entry->setAlignment(8);
+    builder.CreateCondBr(builder.CreateICmpNE(entry, builder.getInt64(0)), linkedBlock, stubBlock);
+
+    // Side effects of the stub: Save the TOC base of the caller in its stack frame and switch to the one of the callee
+    builder.SetInsertPoint(linkedBlock);
+    llvm::Value* toc = builder.CreateLoad(builder.CreateGEP(partition->importLinks, std::vector<llvm::Value*>{
+        builder.getInt32(0), builder.getInt32(index), builder.getInt32(1) }));
+    toc = builder.CreateZExt(toc, builder.getInt64Ty());
+    writeMemory(builder.CreateAdd(getGPR(1), builder.getInt64(40)), getGPR(2));
+    setGPR(2, toc);
+    storeState(builder, offsetof(State, gpr) + 8 * 2, toc, ALIAS_GPR);
+
+    std::vector<llvm::Type*> entryArgs = { builder.getInt8PtrTy(), builder.getInt64Ty()->getPointerTo(), builder.getDoubleTy()->getPointerTo() };
+    llvm::Type* entryType = llvm::FunctionType::get(builder.getVoidTy(), entryArgs, false)->getPointerTo();
+    builder.CreateCall(builder.CreateIntToPtr(entry, entryType), std::vector<llvm::Value*>{ state, gprArray, fprArray });
+    builder.CreateBr(doneBlock);
+
+    // Not linked: Call the stub, which calls the imported function through the runtime
+    builder.SetInsertPoint(stubBlock);
+    hasOpaqueCalls = true;
+    builder.CreateCall(dispatchFunc, std::vector<llvm::Value*>{ state, builder.getInt32(stub), gprArray, fprArray });
+    builder.CreateBr(doneBlock);
+
+    builder.SetInsertPoint(doneBlock);
+    llvm::Instruction* results = loadResults(gprArray, fprArray);
+    runtimeCalls.push_back(std::make_pair(llvm::cast<llvm::Instruction>(gprArray), results));
+}
+
+void Recompiler::createJumpTable(const std::vector<u32>& targets)
+{
+    llvm::BasicBlock* defaultBlock = llvm::BasicBlock::Create(builder.getContext(), "switch_default", function->function);
+    llvm::Value* target = builder.CreateAnd(getCTR(), builder.getInt64(~0x3ULL));
+    target = builder.CreateTrunc(target, builder.getInt32Ty());
+
+    llvm::SwitchInst* switchInst = builder.CreateSwitch(target, defaultBlock, targets.size());
+    for (u32 addr : targets) {
+        switchInst->addCase(builder.getInt32(addr), function->blocks.at(addr).bb);
+    }
+
+    // Targets outside the table are not expected after the bound check, but are still handled as tail calls
+    builder.SetInsertPoint(defaultBlock);
+    createIndirectCall();
+    createReturn();
+}
+
+void Recompiler::createSpinWait(u32 start)
+{
+    llvm::Function* spinFunc = partition->module->getFunction("ppuSpinWait");
+
+    // Watch the first load of the loop body
+    const u32 loadAddr = findSpinLoad(start);
+    if (!loadAddr) {
+        return;
+    }
+    const Instruction load = { nucleus.memory.read32(loadAddr) };
+    llvm::Value* addr;
+    if (load.opcode == 0x1F) {
+        addr = getGPR(load.rb, 32);
+    }
+    else if (load.opcode == 0x3A) {
+        addr = builder.getInt32(load.ds << 2);
+    }
+    else {
+        addr = builder.getInt32(load.d);
+    }
+    if (load.ra) {
+        addr = builder.CreateAdd(addr, getGPR(load.ra, 32));
+    }
+
+    hasOpaqueCalls = true;
+    builder.CreateCall(spinFunc, std::vector<llvm::Value*>{builder.getInt32(currentAddress), addr});
 }
 
 void Recompiler::emit_printf(const char* format, std::vector<llvm::Value*> args)
 {
     llvm::FunctionType* printfType = nullptr;
-    llvm::Function* printfFunc = segment->module->getFunction("printf");
+    llvm::Function* printfFunc = partition->module->getFunction("printf");
 
     if (!printfFunc) {
         printfType = llvm::FunctionType::get(builder.getInt32Ty(), std::vector<llvm::Type*>{}, true);
-        printfFunc = llvm::Function::Create(printfType, llvm::Function::ExternalLinkage, "printf", segment->module);
+        printfFunc = llvm::Function::Create(printfType, llvm::Function::ExternalLinkage, "printf", partition->module);
         printfFunc->setCallingConv(llvm::CallingConv::C);
     }
 
@@ -11,40 +11,77 @@
 
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
 
 namespace cpu {
 namespace ppu {
 
+// Version of the generated code: Increment it whenever the output of the recompiler changes
+static const u32 RECOMPILER_VERSION = 25;
+
 class Recompiler
 {
     Function* function;
+    Partition* partition;
     Segment* segment;
 
     llvm::IRBuilder<> builder;
 
     // LLVM Intrinsics
     llvm::Function* getIntrinsicIntN(llvm::Intrinsic::ID intr, int bits) {
-        return llvm::Intrinsic::getDeclaration(segment->module, intr, builder.getIntNTy(bits));
+        return llvm::Intrinsic::getDeclaration(partition->module, intr, builder.getIntNTy(bits));
     }
     llvm::Function* getIntrinsicInt8(llvm::Intrinsic::ID intr) {
-        return llvm::Intrinsic::getDeclaration(segment->module, intr, builder.getInt8Ty());
+        return llvm::Intrinsic::getDeclaration(partition->module, intr, builder.getInt8Ty());
     }
     llvm::Function* getIntrinsicInt16(llvm::Intrinsic::ID intr) {
-        return llvm::Intrinsic::getDeclaration(segment->module, intr, builder.getInt16Ty());
+        return llvm::Intrinsic::getDeclaration(partition->module, intr, builder.getInt16Ty());
     }
     llvm::Function* getIntrinsicInt32(llvm::Intrinsic::ID intr) {
-        return llvm::Intrinsic::getDeclaration(segment->module, intr, builder.getInt32Ty());
+        return llvm::Intrinsic::getDeclaration(partition->module, intr, builder.getInt32Ty());
     }
     llvm::Function* getIntrinsicInt64(llvm::Intrinsic::ID intr) {
-        return llvm::Intrinsic::getDeclaration(segment->module, intr, builder.getInt64Ty());
+        return llvm::Intrinsic::getDeclaration(partition->module, intr, builder.getInt64Ty());
     }
     llvm::Function* getIntrinsicFloat(llvm::Intrinsic::ID intr) {
-        return llvm::Intrinsic::getDeclaration(segment->module, intr, builder.getFloatTy());
+        return llvm::Intrinsic::getDeclaration(partition->module, intr, builder.getFloatTy());
     }
     llvm::Function* getIntrinsicDouble(llvm::Intrinsic::ID intr) {
-        return llvm::Intrinsic::getDeclaration(segment->module, intr, builder.getDoubleTy());
+        return llvm::Intrinsic::getDeclaration(partition->module, intr, builder.getDoubleTy());
     }
 
+    // Arguments passed by the calling convention: Thread state (i8*) and guest memory base (i8*)
+    llvm::Value* state = nullptr;
+    llvm::Value* memoryBase = nullptr;
+
+    /**
+     * Alias analysis
+     */
+    // Disjoint classes of memory accessed by recompiled code: Guest memory and each group of registers in the thread state
+    enum AliasClass {
+        ALIAS_MEMORY = 0,
+        ALIAS_GPR,
+        ALIAS_FPR,
+        ALIAS_VR,
+        ALIAS_CR,
+        ALIAS_XER,
+        ALIAS_CTR,
+        ALIAS_LR,
+        ALIAS_FPSCR,
+        ALIAS_VSCR,
+        ALIAS_COUNT,
+    };
+
+    // Attach the TBAA tag of the class to a load or store
+    void setAliasClass(llvm::Instruction* access, AliasClass aliasClass);
+
+    // Calls to the runtime which might access guest memory without being passed the memory base
+    bool hasOpaqueCalls = false;
+
+    // Access registers of the thread state, at the specified offset of the State structure
+    llvm::Value* loadState(llvm::IRBuilder<>& stateBuilder, size_t offset, llvm::Type* type, AliasClass aliasClass);
+    void storeState(llvm::IRBuilder<>& stateBuilder, size_t offset, llvm::Value* value, AliasClass aliasClass);
+
     // Register allocation
     llvm::AllocaInst* gpr[32] = {};
     llvm::AllocaInst* fpr[32] = {};
@@ -53,6 +90,7 @@ class Recompiler
     llvm::AllocaInst* fpscr = nullptr;
     llvm::AllocaInst* xer = nullptr;
     llvm::AllocaInst* ctr = nullptr;
+    llvm::AllocaInst* lr = nullptr;
 
     // Register access
     llvm::AllocaInst* allocaVariable(llvm::Type* type, const llvm::Twine& name);
@@ -63,12 +101,22 @@ class Recompiler
     llvm::Value* getFPR(int index);
     void setFPR(int index, llvm::Value* value);
 
+    // Vector registers are stored as <4 x i32> with their elements in host order (reversed), and read as any
+    // vector type of 128 bits, which only requires a bitcast
+    llvm::Value* getVR(int index, llvm::Type* type);
     llvm::Value* getVR_u8(int index);
     llvm::Value* getVR_u16(int index);
     llvm::Value* getVR_u32(int index);
     llvm::Value* getVR_f32(int index);
+    llvm::Value* getVR_u128(int index);
     void setVR(int index, llvm::Value* value);
 
+    llvm::Value* getCTR();
+    void setCTR(llvm::Value* value);
+
+    llvm::Value* getLR();
+    void setLR(llvm::Value* value);
+
     /**
      * Operation flags
      */
@@ -76,22 +124,153 @@ class Recompiler
     void updateCR1(llvm::Value* value); // Floating-Point instructions with RC bit
     void updateCR6(llvm::Value* value); // Vector instructions with RC bit
 
+    // Set VSCR[SAT] if any lane of the boolean vector is set
+    void updateSAT(llvm::Value* saturated);
+
+    // Read a bit of CR from the thread state, including the field 0 pending in the interpreter
+    llvm::Value* getCRBit(u32 bit);
+
+    // Read XER[SO] from the thread state (as an i32)
+    llvm::Value* getXERSO();
+
+    // Write a field of CR to the thread state, discarding the field 0 pending in the interpreter
+    void setCRField(u32 field, llvm::Value* value);
+
+    // Get a pointer to the reservation of the thread
+    llvm::Value* getReservation();
+
+    // Evaluate the condition of a conditional branch, decrementing CTR if the BO field requests it
+    llvm::Value* createBranchCondition(u32 bo, u32 bi);
+
+    // Determines whether any of the flags updated by the current instruction might be read afterwards
+    bool isFlagLive(FlagSet flags) const {
+        return (liveFlags & flags) != 0;
+    }
+
     /**
      * Memory access
      */
+    // Get a pointer to guest memory, based on the memory base argument
+    llvm::Value* getMemoryPointer(llvm::Value* addr, llvm::Type* type);
+
     // Read specified number of bits from memory swapping endianness if necessary
     llvm::Value* readMemory(llvm::Value* addr, int bits);
 
     // Write value to memory swapping endianness if necessary
     void writeMemory(llvm::Value* addr, llvm::Value* value);
 
+    // Read and write 16 aligned bytes as a vector with its elements in host order
+    llvm::Value* readMemoryVector(llvm::Value* addr);
+    void writeMemoryVector(llvm::Value* addr, llvm::Value* value);
+
+    /**
+     * Vector operations
+     */
+    // Address of vector loads and stores: (rA|0) + rB
+    llvm::Value* getVectorAddress(Instruction code);
+
+    // Shuffle the bytes of two vectors as vperm does, with a constant shuffle if the control vector is known
+    llvm::Value* createVectorPermute(llvm::Value* va, llvm::Value* vb, llvm::Value* vc);
+
+    // Saturating addition and subtraction, updating VSCR[SAT]
+    llvm::Value* createSaturatingAdd(llvm::Value* va, llvm::Value* vb, bool isSigned);
+    llvm::Value* createSaturatingSub(llvm::Value* va, llvm::Value* vb, bool isSigned);
+    llvm::Value* createSaturation(llvm::Value* va, llvm::Value* vb, bool isSigned, bool isSub);
+
+    // Rounded average of the lanes, computed with twice their width
+    llvm::Value* createAverage(llvm::Value* va, llvm::Value* vb, bool isSigned);
+
+    // Interleave the elements of the high or low halves of two vectors (in guest order)
+    llvm::Value* createMerge(llvm::Value* va, llvm::Value* vb, bool high);
+
+    // Replicate the element of a vector (in guest order) to every lane
+    llvm::Value* createSplat(llvm::Value* vb, u32 element);
+
+    // Constant mask of a shufflevector instruction
+    llvm::Constant* getShuffleMask(const std::vector<u32>& mask);
+
+    /**
+     * Function calls
+     */
+    // Get a callable value for a function of the segment, either direct or through the function table
+    llvm::Value* getFunction(Function& target);
+
+    // Call a function of the segment with the specified guest arguments, following the calling convention
+    llvm::Value* createCall(Function& target, const std::vector<llvm::Value*>& guestArgs);
+
+    // Call a function outside the segment through the dispatch table, passing the argument registers
+    void createDispatch(u32 target);
+
+    // Call the function at the address held by CTR through the inline cache of the current instruction
+    void createIndirectCall();
+
+    // Call the function imported by an import stub of the segment through its link, or through the stub if not linked
+    void createImportCall(u32 stub);
+
+    // Jump to the block of the function at the address held by CTR, among the targets of a recovered jump table
+    void createJumpTable(const std::vector<u32>& targets);
+
+    // Pass all argument registers through arrays to callees of unknown type, and read back the return registers
+    void storeArguments(llvm::Value*& gprArray, llvm::Value*& fprArray);
+    llvm::Instruction* loadResults(llvm::Value* gprArray, llvm::Value* fprArray);
+
+    /**
+     * Spin loops
+     */
+    // Back off before taking the back edge of the spin loop starting at the address
+    void createSpinWait(u32 start);
+
+    /**
+     * Profiling
+     */
+    // Counters of the block being recompiled: Executions and taken branches (null if not profiled)
+    u64* blockCounters = nullptr;
+
+    // Increment a profile counter by one, or by a boolean value
+    void createCounter(u64* counter, llvm::Value* value=nullptr);
+
+    // Get the weights of a conditional branch from the profile if available, or from its static prediction
+    llvm::MDNode* getBranchWeights(Instruction code, u32 target);
+
+    /**
+     * Instrumentation
+     */
+    // Values read in the prolog of functions profiled with the cycle counter
+    llvm::Value* profileStart = nullptr;
+    llvm::Value* profileChildCycles = nullptr;
+
+    // Record the cycles spent in the function before returning
+    void createProfileExit();
+
+    /**
+     * Mixed mode
+     */
+    // Calls to the interpreter, around which the registers of the function are synchronized with the thread state
+    std::vector<llvm::CallInst*> interpreterCalls;
+
+    // Calls to recompiled functions, directly or through entry points or the runtime (which might run the
+    // interpreter), synchronized as well:
+    // Registers are spilled before the first instruction and reloaded before the second one (or right after
+    // the first one if null, i.e. before the results of direct calls are saved)
+    std::vector<std::pair<llvm::Instruction*, llvm::Instruction*>> runtimeCalls;
+
+    // Returns of the function, before which its registers are spilled
+    std::vector<llvm::Instruction*> returns;
+
+    // Store the registers used by the function in the thread state, and load them back
+    void spillRegisters(llvm::IRBuilder<>& spillBuilder);
+    void reloadRegisters(llvm::IRBuilder<>& reloadBuilder);
+
+    // Resume the interpreter at the address until the function returns, and return its result
+    void createInterpreterExit(u32 target);
+
     /**
      * Logging & Debugging
      */
     void emit_printf(const char* format, std::vector<llvm::Value*> args);
 
 public:
-    Recompiler(Segment* segment, Function* function);
+    Recompiler(Segment* segment, Partition* partition, Function* function);
 
     // Specifies the block that is being recompiled
     void setInsertPoint(llvm::BasicBlock* block);
@@ -102,11 +281,39 @@ public:
 
     void createProlog();
 
+    // Define the entry point of the function, called through the dispatch table
+    void createEntry();
+
+    // Get a pointer to a member of the thread state passed to the entry point
+    llvm::Value* getEntryState(llvm::Value* entryState, size_t offset, llvm::Type* type);
+
+    // Specifies the profile counters of the block that is being recompiled, counting its executions if profiled
+    void createBlockCounter(u64* counters);
+
+    // Execute the current instruction with the interpreter, used for instructions not supported by the recompiler
+    void createInterpreterFallback();
+
+    // Number of calls to the interpreter generated so far
+    size_t getInterpreterCallCount() const {
+        return interpreterCalls.size();
+    }
+
+    // Synchronize the registers with the thread state around the calls to the interpreter, once every block is recompiled
+    void createStateSync();
+
+    // Mark the memory base as not aliasing other pointers, once every block is recompiled
+    void createArgumentAttributes();
+
     // Function information
     FunctionTypeOut returnType;
 
     // Recompiler status
     u32 currentAddress;
+    FlagSet liveFlags = FLAG_ALL;  // Flags that might be read after the current instruction
+
+    // Flags whose updates are emitted by recompiled instructions so far. CR1, CR6 and
+    // XER updates are not emitted at all, so there is nothing to eliminate for them
+    static const FlagSet EMITTED_FLAGS = FLAG_CR0;
 
     /**
      * PPC64 Instructions:
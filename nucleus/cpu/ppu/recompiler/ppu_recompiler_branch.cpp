@@ -4,6 +4,8 @@
  */
 
 #include "ppu_recompiler.h"
+#include "nucleus/config.h"
+#include "nucleus/cpu/ppu/ppu_spin.h"
 
 namespace cpu {
 namespace ppu {
@@ -17,8 +19,18 @@ void Recompiler::bx(Instruction code)
 {
     const u32 target = code.aa ? (code.li << 2) : (currentAddress + (code.li << 2)) & ~0x3;
 
+    // Function call outside the segment
+    if (code.lk && segment->functions.find(target) == segment->functions.end()) {
+        createDispatch(target);
+    }
+
+    // Call to an import stub: Linked directly to the imported function, if possible
+    else if (code.lk && segment->importStubs.find(target) != segment->importStubs.end()) {
+        createImportCall(target);
+    }
+
     // Function call
-    if (code.lk) {
+    else if (code.lk) {
         Function& targetFunc = segment->functions.at(target);
 
         // Generate array of arguments
@@ -33,13 +45,14 @@ void Recompiler::bx(Instruction code)
                 arguments.push_back(getFPR(1 + index));
                 break;
             case FUNCTION_IN_VECTOR:
-                arguments.push_back(getVR_u32(2 + index));
+                arguments.push_back(getVR_u128(2 + index));
                 break;
             }
             index += 1;
         }
 
-        llvm::Value* result = builder.CreateCall(targetFunc.function, arguments);
+        llvm::Instruction* call = llvm::cast<llvm::Instruction>(createCall(targetFunc, arguments));
+        llvm::Value* result = call;
 
         // Save return value
         switch (targetFunc.type_out) {
@@ -47,21 +60,24 @@ void Recompiler::bx(Instruction code)
             setGPR(3, result);
             break;
         case FUNCTION_OUT_FLOAT:
-            setFPR(1, result);
-            break;
         case FUNCTION_OUT_FLOAT_X2:
-            setFPR(1, result); // TODO
-            break;
         case FUNCTION_OUT_FLOAT_X3:
-            setFPR(1, result); // TODO
-            break;
         case FUNCTION_OUT_FLOAT_X4:
-            setFPR(1, result); // TODO
+            // Results on f2:f4 are reloaded from the thread state
+            setFPR(1, result);
             break;
         case FUNCTION_OUT_VECTOR:
             setVR(2, result);
             break;
         }
+
+        // Registers not passed as arguments are exchanged through the thread state
+        runtimeCalls.push_back(std::make_pair(call, nullptr));
+    }
+
+    // Jump outside the function: Continue in the interpreter
+    else if (function->blocks.find(target) == function->blocks.end()) {
+        createInterpreterExit(target);
     }
 
     // Simple unconditional branch
@@ -76,24 +92,77 @@ void Recompiler::bcx(Instruction code)
     const u32 targetAddr = code.aa ? (code.bd << 2) : (currentAddress + (code.bd << 2)) & ~0x3;
     const u32 nextAddr = (currentAddress + 4) & ~0x3;
 
-    llvm::Value* cond;
-    cond = builder.getInt1(true); // TODO: This is wrong
+    llvm::Value* cond = createBranchCondition(code.bo, code.bi);
+    if (partition->profiled && blockCounters) {
+        createCounter(&blockCounters[1], cond);
+    }
 
     // Conditional function call
     if (code.lk) {
         // TODO
     }
 
+    // Spin loop: Back off before taking the back edge
+    else if (config.ppuSpinDetection && isSpinLoop(targetAddr, currentAddress)) {
+        Block& targetBlock = function->blocks.at(targetAddr);
+        Block& nextBlock = function->blocks.at(nextAddr);
+        llvm::BasicBlock* spinBlock = llvm::BasicBlock::Create(builder.getContext(), "spin", function->function);
+        builder.CreateCondBr(cond, spinBlock, nextBlock.bb, getBranchWeights(code, targetAddr));
+        builder.SetInsertPoint(spinBlock);
+        createSpinWait(targetAddr);
+        builder.CreateBr(targetBlock.bb);
+    }
+
     // Simple conditional branch
     else {
         Block& targetBlock = function->blocks.at(targetAddr);
         Block& nextBlock = function->blocks.at(nextAddr);
-        builder.CreateCondBr(cond, targetBlock.bb, nextBlock.bb);
+        builder.CreateCondBr(cond, targetBlock.bb, nextBlock.bb, getBranchWeights(code, targetAddr));
     }
 }
 
 void Recompiler::bcctrx(Instruction code)
 {
+    // Jumps through a jump table recovered by the analyzer stay inside the function
+    auto table = segment->jumpTables.find(currentAddress);
+    if (!code.lk && table != segment->jumpTables.end()) {
+        createJumpTable(table->second);
+        return;
+    }
+
+    // Conditional branches skip the call (BO[2] is always set, since CTR cannot be decremented here)
+    llvm::BasicBlock* nextBlock = nullptr;
+    if ((code.bo & 0x14) != 0x14) {
+        llvm::LLVMContext& context = builder.getContext();
+        llvm::Value* cond = createBranchCondition(code.bo | 0x04, code.bi);
+        llvm::BasicBlock* takenBlock = llvm::BasicBlock::Create(context, "bcctr_taken", function->function);
+        nextBlock = llvm::BasicBlock::Create(context, "bcctr_next", function->function);
+        builder.CreateCondBr(cond, takenBlock, nextBlock);
+        builder.SetInsertPoint(takenBlock);
+    }
+
+    createIndirectCall();
+
+    // Unknown jumps are tail calls: Return the result of the callee
+    if (!code.lk) {
+        createReturn();
+    } else if (nextBlock) {
+        builder.CreateBr(nextBlock);
+    }
+    if (!nextBlock) {
+        return;
+    }
+
+    // Branch not taken: Continue with the next instruction
+    builder.SetInsertPoint(nextBlock);
+    if (!code.lk) {
+        const u32 nextAddr = currentAddress + 4;
+        if (function->blocks.find(nextAddr) != function->blocks.end()) {
+            builder.CreateBr(function->blocks.at(nextAddr).bb);
+        } else {
+            createInterpreterExit(nextAddr);
+        }
+    }
 }
 
 void Recompiler::bclrx(Instruction code)
@@ -112,58 +181,72 @@ void Recompiler::bclrx(Instruction code)
 
 void Recompiler::crand(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::crandc(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::creqv(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::crnand(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::crnor(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::cror(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::crorc(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::crxor(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mcrf(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::sc(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::td(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::tdi(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::tw(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::twi(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 }  // namespace ppu
@@ -18,22 +18,49 @@ namespace ppu {
 
 void Recompiler::mfocrf(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mfspr(Instruction code)
 {
+    const u32 n = (code.spr >> 5) | ((code.spr & 0x1f) << 5);
+    switch (n) {
+    case 0x008: // LR
+        setGPR(code.rd, getLR());
+        break;
+    case 0x009: // CTR
+        setGPR(code.rd, getCTR());
+        break;
+    default:
+        createInterpreterFallback();
+        break;
+    }
 }
 
 void Recompiler::mtocrf(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mtspr(Instruction code)
 {
+    const u32 n = (code.spr >> 5) | ((code.spr & 0x1f) << 5);
+    switch (n) {
+    case 0x008: // LR
+        setLR(getGPR(code.rs));
+        break;
+    case 0x009: // CTR
+        setCTR(getGPR(code.rs));
+        break;
+    default:
+        createInterpreterFallback();
+        break;
+    }
 }
 
 void Recompiler::mftb(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::dcbf(Instruction code)
@@ -54,6 +81,7 @@ void Recompiler::dcbtst(Instruction code)
 
 void Recompiler::dcbz(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::icbi(Instruction code)
@@ -62,10 +90,12 @@ void Recompiler::icbi(Instruction code)
 
 void Recompiler::eciwx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::ecowx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 }  // namespace ppu
@@ -20,9 +20,6 @@ void Recompiler::fabsx(Instruction code)
 
     llvm::Function* fabs = getIntrinsicDouble(llvm::Intrinsic::fabs);
     frd = builder.CreateCall(fabs, frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -34,9 +31,6 @@ void Recompiler::faddx(Instruction code)
     llvm::Value* frd;
 
     frd = builder.CreateFAdd(fra, frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -49,39 +43,43 @@ void Recompiler::faddsx(Instruction code)
 
     frd = builder.CreateFAdd(fra, frb);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
 
 void Recompiler::fcfidx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fcmpo(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fcmpu(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fctidx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fctidzx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fctiwx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fctiwzx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fdivx(Instruction code)
@@ -91,9 +89,6 @@ void Recompiler::fdivx(Instruction code)
     llvm::Value* frd;
 
     frd = builder.CreateFDiv(fra, frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -106,9 +101,6 @@ void Recompiler::fdivsx(Instruction code)
 
     frd = builder.CreateFDiv(fra, frb);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -122,9 +114,6 @@ void Recompiler::fmaddx(Instruction code)
 
     llvm::Function* fmuladd = getIntrinsicDouble(llvm::Intrinsic::fmuladd);
     frd = builder.CreateCall3(fmuladd, fra, frc, frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -139,9 +128,6 @@ void Recompiler::fmaddsx(Instruction code)
     llvm::Function* fmuladd = getIntrinsicDouble(llvm::Intrinsic::fmuladd);
     frd = builder.CreateCall3(fmuladd, fra, frc, frb);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -152,9 +138,6 @@ void Recompiler::fmrx(Instruction code)
     llvm::Value* frd;
 
     frd = frb;
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -169,9 +152,6 @@ void Recompiler::fmsubx(Instruction code)
     // TEST: Is negating frb and calling llvm::Intrinsic::fmuladd faster?
     frd = builder.CreateFMul(fra, frc);
     frd = builder.CreateFSub(frd, frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -187,9 +167,6 @@ void Recompiler::fmsubsx(Instruction code)
     frd = builder.CreateFMul(fra, frc);
     frd = builder.CreateFSub(frd, frb);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -201,9 +178,6 @@ void Recompiler::fmulx(Instruction code)
     llvm::Value* frd;
 
     frd = builder.CreateFMul(fra, frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -216,9 +190,6 @@ void Recompiler::fmulsx(Instruction code)
 
     frd = builder.CreateFMul(fra, frb);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -231,9 +202,6 @@ void Recompiler::fnabsx(Instruction code)
     llvm::Function* fabs = getIntrinsicDouble(llvm::Intrinsic::fabs);
     frd = builder.CreateCall(fabs, frb);
     frd = builder.CreateFNeg(frd);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -244,9 +212,6 @@ void Recompiler::fnegx(Instruction code)
     llvm::Value* frd;
 
     frd = builder.CreateFNeg(frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -261,9 +226,6 @@ void Recompiler::fnmaddx(Instruction code)
     llvm::Function* fmuladd = getIntrinsicDouble(llvm::Intrinsic::fmuladd);
     frd = builder.CreateCall3(fmuladd, fra, frc, frb);
     frd = builder.CreateFNeg(frd);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -279,9 +241,6 @@ void Recompiler::fnmaddsx(Instruction code)
     frd = builder.CreateCall3(fmuladd, fra, frc, frb);
     frd = builder.CreateFNeg(frd);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -297,9 +256,6 @@ void Recompiler::fnmsubx(Instruction code)
     frd = builder.CreateFMul(fra, frc);
     frd = builder.CreateFSub(frd, frb);
     frd = builder.CreateNeg(frd);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -316,27 +272,28 @@ void Recompiler::fnmsubsx(Instruction code)
     frd = builder.CreateFSub(frd, frb);
     frd = builder.CreateNeg(frd);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
 
 void Recompiler::fresx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::frspx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::frsqrtex(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fselx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::fsqrtx(Instruction code)
@@ -346,9 +303,6 @@ void Recompiler::fsqrtx(Instruction code)
 
     llvm::Function* sqrt = getIntrinsicDouble(llvm::Intrinsic::sqrt);
     frd = builder.CreateCall(sqrt, frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -361,9 +315,6 @@ void Recompiler::fsqrtsx(Instruction code)
     llvm::Function* sqrt = getIntrinsicDouble(llvm::Intrinsic::sqrt);
     frd = builder.CreateCall(sqrt, frb);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -375,9 +326,6 @@ void Recompiler::fsubx(Instruction code)
     llvm::Value* frd;
 
     frd = builder.CreateFSub(fra, frb);
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
@@ -390,35 +338,38 @@ void Recompiler::fsubsx(Instruction code)
 
     frd = builder.CreateFSub(fra, frb);
     frd = builder.CreateFPTrunc(frd, builder.getFloatTy());
-    if (code.rc) {
-        // TODO: CR1 update
-    }
 
     setFPR(code.frd, frd);
 }
 
 void Recompiler::mcrfs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mffsx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mtfsb0x(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mtfsb1x(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mtfsfix(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mtfsfx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 }  // namespace ppu
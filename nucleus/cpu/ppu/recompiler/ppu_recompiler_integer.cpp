@@ -19,20 +19,9 @@ void Recompiler::addx(Instruction code)
     llvm::Value* rb = getGPR(code.rb);
     llvm::Value* rd;
 
-    if (code.oe) {
-        llvm::Function* sadd = getIntrinsicInt64(llvm::Intrinsic::sadd_with_overflow);
-        llvm::Value* ov;
-
-        rd = builder.CreateCall2(sadd, ra, rb);
-        rd = builder.CreateExtractValue(rd, 0);
-        ov = builder.CreateExtractValue(rd, 1);
-        // TODO: XER OV update
-    } else {
-        rd = builder.CreateAdd(ra, rb);
-    }
-
-    if (code.rc) {
-        // TODO: CR0 update
+    rd = builder.CreateAdd(ra, rb);
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(rd);
     }
 
     setGPR(code.rd, rd);
@@ -44,20 +33,9 @@ void Recompiler::addcx(Instruction code)
     llvm::Value* rb = getGPR(code.rb);
     llvm::Value* rd;
 
-    llvm::Function* uadd = getIntrinsicInt64(llvm::Intrinsic::uadd_with_overflow);
-    llvm::Value* result;
-    llvm::Value* ca;
-
-    result = builder.CreateCall2(uadd, ra, rb);
-    rd = builder.CreateExtractValue(result, 0);
-    ca = builder.CreateExtractValue(result, 1);
-    // TODO: XER CA update
-
-    if (code.oe) {
-        // TODO: XER OV update
-    }
-    if (code.rc) {
-        // TODO: CR0 update
+    rd = builder.CreateAdd(ra, rb);
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(rd);
     }
 
     setGPR(code.rd, rd);
@@ -72,11 +50,8 @@ void Recompiler::addex(Instruction code)
     // TODO: Add XER[CA]
     rd = builder.CreateAdd(ra, rb);
 
-    if (code.oe) {
-        // TODO: XER OV update
-    }
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(rd);
     }
 
     setGPR(code.rd, rd);
@@ -118,7 +93,9 @@ void Recompiler::addic_(Instruction code)
 
     rd = builder.CreateAdd(ra, simm);
     // TODO: XER CA update
-    // TODO: CR0 update
+    if (isFlagLive(FLAG_CR0)) {
+        updateCR0(rd);
+    }
 
     setGPR(code.rd, rd);
 }
@@ -140,10 +117,12 @@ void Recompiler::addis(Instruction code)
 
 void Recompiler::addmex(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::addzex(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::andx(Instruction code)
@@ -153,8 +132,8 @@ void Recompiler::andx(Instruction code)
     llvm::Value* ra;
 
     ra = builder.CreateAnd(rs, rb);
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -162,6 +141,7 @@ void Recompiler::andx(Instruction code)
 
 void Recompiler::andcx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::andi_(Instruction code)
@@ -170,7 +150,9 @@ void Recompiler::andi_(Instruction code)
     llvm::Value* ra;
 
     ra = builder.CreateAnd(rs, code.uimm);
-    // TODO: CR0 update
+    if (isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
+    }
 
     setGPR(code.ra, ra);
 }
@@ -181,29 +163,36 @@ void Recompiler::andis_(Instruction code)
     llvm::Value* ra;
 
     ra = builder.CreateAnd(rs, code.uimm << 16);
-    // TODO: CR0 update
+    if (isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
+    }
 
     setGPR(code.ra, ra);
 }
 
 void Recompiler::cmp(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::cmpi(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::cmpl(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::cmpli(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::divdx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::cntlzdx(Instruction code)
@@ -213,8 +202,8 @@ void Recompiler::cntlzdx(Instruction code)
 
     llvm::Function* ctlz = getIntrinsicInt64(llvm::Intrinsic::ctlz);
     ra = builder.CreateCall2(ctlz, rs, builder.getInt1(false));
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -228,8 +217,8 @@ void Recompiler::cntlzwx(Instruction code)
     llvm::Function* ctlz = getIntrinsicInt32(llvm::Intrinsic::ctlz);
     ra = builder.CreateCall2(ctlz, rs, builder.getInt1(false));
     ra = builder.CreateZExt(ra, builder.getInt64Ty());
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -237,14 +226,17 @@ void Recompiler::cntlzwx(Instruction code)
 
 void Recompiler::divdux(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::divwx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::divwux(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::eqvx(Instruction code)
@@ -255,8 +247,8 @@ void Recompiler::eqvx(Instruction code)
 
     ra = builder.CreateXor(rs, rb);
     ra = builder.CreateNeg(ra);
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -268,8 +260,8 @@ void Recompiler::extsbx(Instruction code)
     llvm::Value* ra;
 
     ra = builder.CreateSExt(rs, builder.getInt64Ty());
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -281,8 +273,8 @@ void Recompiler::extshx(Instruction code)
     llvm::Value* ra;
 
     ra = builder.CreateSExt(rs, builder.getInt64Ty());
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -294,8 +286,8 @@ void Recompiler::extswx(Instruction code)
     llvm::Value* ra;
 
     ra = builder.CreateSExt(rs, builder.getInt64Ty());
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -303,30 +295,37 @@ void Recompiler::extswx(Instruction code)
 
 void Recompiler::mulhdx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mulhdux(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mulhwx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mulhwux(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mulldx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mulli(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mullwx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::nandx(Instruction code)
@@ -337,8 +336,8 @@ void Recompiler::nandx(Instruction code)
 
     ra = builder.CreateAnd(rs, rb);
     ra = builder.CreateNeg(ra);
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -350,11 +349,8 @@ void Recompiler::negx(Instruction code)
     llvm::Value* rd;
 
     rd = builder.CreateSub(builder.getInt64(0), ra);
-    if (code.oe) {
-        // TODO: XER OV update
-    }
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(rd);
     }
 
     setGPR(code.rd, rd);
@@ -368,8 +364,8 @@ void Recompiler::norx(Instruction code)
 
     ra = builder.CreateOr(rs, rb);
     ra = builder.CreateNeg(ra);
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -382,8 +378,8 @@ void Recompiler::orx(Instruction code)
     llvm::Value* ra;
 
     ra = builder.CreateOr(rs, rb);
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -397,8 +393,8 @@ void Recompiler::orcx(Instruction code)
 
     rb = builder.CreateNot(rb);
     ra = builder.CreateOr(rs, rb);
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
@@ -426,90 +422,112 @@ void Recompiler::oris(Instruction code)
 
 void Recompiler::rldc_lr(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::rldicx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::rldiclx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::rldicrx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::rldimix(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::rlwimix(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::rlwinmx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::rlwnmx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::sldx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::slwx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::sradx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::sradix(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::srawx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::srawix(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::srdx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::srwx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::subfx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::subfcx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::subfex(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::subfic(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::subfmex(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::subfzex(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::xorx(Instruction code)
@@ -519,8 +537,8 @@ void Recompiler::xorx(Instruction code)
     llvm::Value* ra;
 
     ra = builder.CreateXor(rs, rb);
-    if (code.rc) {
-        // TODO: CR0 update
+    if (code.rc && isFlagLive(FLAG_CR0)) {
+        updateCR0(ra);
     }
 
     setGPR(code.ra, ra);
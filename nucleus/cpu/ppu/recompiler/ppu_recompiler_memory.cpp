@@ -4,6 +4,7 @@
  */
 
 #include "ppu_recompiler.h"
+#include "nucleus/cpu/ppu/ppu_state.h"
 
 namespace cpu {
 namespace ppu {
@@ -82,10 +83,22 @@ void Recompiler::ld(Instruction code)
 
 void Recompiler::ldarx(Instruction code)
 {
+    llvm::Function* loadFunc = partition->module->getFunction("reservationLoad64");
+    llvm::Value* addr = getGPR(code.rb, 32);
+    llvm::Value* rd;
+
+    if (code.ra) {
+        addr = builder.CreateAdd(addr, getGPR(code.ra, 32));
+    }
+
+    hasOpaqueCalls = true;
+    rd = builder.CreateCall(loadFunc, std::vector<llvm::Value*>{ getReservation(), addr });
+    setGPR(code.rd, rd);
 }
 
 void Recompiler::ldbrx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::ldu(Instruction code)
@@ -273,6 +286,7 @@ void Recompiler::lhax(Instruction code)
 
 void Recompiler::lhbrx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lhz(Instruction code)
@@ -329,14 +343,17 @@ void Recompiler::lhzx(Instruction code)
 
 void Recompiler::lmw(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lswi(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lswx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lwa(Instruction code)
@@ -355,6 +372,18 @@ void Recompiler::lwa(Instruction code)
 
 void Recompiler::lwarx(Instruction code)
 {
+    llvm::Function* loadFunc = partition->module->getFunction("reservationLoad32");
+    llvm::Value* addr = getGPR(code.rb, 32);
+    llvm::Value* rd;
+
+    if (code.ra) {
+        addr = builder.CreateAdd(addr, getGPR(code.ra, 32));
+    }
+
+    hasOpaqueCalls = true;
+    rd = builder.CreateCall(loadFunc, std::vector<llvm::Value*>{ getReservation(), addr });
+    rd = builder.CreateZExt(rd, builder.getInt64Ty());
+    setGPR(code.rd, rd);
 }
 
 void Recompiler::lwaux(Instruction code)
@@ -384,6 +413,7 @@ void Recompiler::lwax(Instruction code)
 
 void Recompiler::lwbrx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lwz(Instruction code)
@@ -495,6 +525,21 @@ void Recompiler::std(Instruction code)
 
 void Recompiler::stdcx_(Instruction code)
 {
+    llvm::Function* storeFunc = partition->module->getFunction("reservationStore64");
+    llvm::Value* addr = getGPR(code.rb, 32);
+    llvm::Value* success;
+
+    if (code.ra) {
+        addr = builder.CreateAdd(addr, getGPR(code.ra, 32));
+    }
+
+    hasOpaqueCalls = true;
+    success = builder.CreateCall(storeFunc, std::vector<llvm::Value*>{ getReservation(), addr, getGPR(code.rs) });
+
+    // CR0 = 0b00 || success || XER[SO]
+    llvm::Value* cr0 = builder.CreateShl(success, PPU_CR::CR_EQ);
+    cr0 = builder.CreateOr(cr0, builder.CreateShl(getXERSO(), PPU_CR::CR_SO));
+    setCRField(0, cr0);
 }
 
 void Recompiler::stdu(Instruction code)
@@ -577,6 +622,7 @@ void Recompiler::stfdx(Instruction code)
 
 void Recompiler::stfiwx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stfs(Instruction code)
@@ -644,6 +690,7 @@ void Recompiler::sth(Instruction code)
 
 void Recompiler::sthbrx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::sthu(Instruction code)
@@ -679,14 +726,17 @@ void Recompiler::sthx(Instruction code)
 
 void Recompiler::stmw(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stswi(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stswx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stw(Instruction code)
@@ -703,10 +753,26 @@ void Recompiler::stw(Instruction code)
 
 void Recompiler::stwbrx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stwcx_(Instruction code)
 {
+    llvm::Function* storeFunc = partition->module->getFunction("reservationStore32");
+    llvm::Value* addr = getGPR(code.rb, 32);
+    llvm::Value* success;
+
+    if (code.ra) {
+        addr = builder.CreateAdd(addr, getGPR(code.ra, 32));
+    }
+
+    hasOpaqueCalls = true;
+    success = builder.CreateCall(storeFunc, std::vector<llvm::Value*>{ getReservation(), addr, getGPR(code.rs, 32) });
+
+    // CR0 = 0b00 || success || XER[SO]
+    llvm::Value* cr0 = builder.CreateShl(success, PPU_CR::CR_EQ);
+    cr0 = builder.CreateOr(cr0, builder.CreateShl(getXERSO(), PPU_CR::CR_SO));
+    setCRField(0, cr0);
 }
 
 void Recompiler::stwu(Instruction code)
@@ -28,94 +28,203 @@ void Recompiler::dstst(Instruction code)
 
 void Recompiler::lvebx(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vd;
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0xFULL));
+    vd = readMemoryVector(addr);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvehx(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vd;
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0xFULL));
+    vd = readMemoryVector(addr);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvewx(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vd;
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0xFULL));
+    vd = readMemoryVector(addr);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvlx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lvlxl(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lvrx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lvrxl(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::lvsl(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* sh;
+    llvm::Value* vd;
+
+    // Host byte i holds the guest index 15-i+sh
+    std::vector<u8> indices;
+    for (u8 i = 0; i < 16; i++) {
+        indices.push_back(15 - i);
+    }
+    sh = builder.CreateTrunc(builder.CreateAnd(addr, builder.getInt64(0xF)), builder.getInt8Ty());
+    vd = builder.CreateAdd(llvm::ConstantDataVector::get(builder.getContext(), indices), builder.CreateVectorSplat(16, sh));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvsr(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* sh;
+    llvm::Value* vd;
+
+    // Host byte i holds the guest index 31-i-sh
+    std::vector<u8> indices;
+    for (u8 i = 0; i < 16; i++) {
+        indices.push_back(31 - i);
+    }
+    sh = builder.CreateTrunc(builder.CreateAnd(addr, builder.getInt64(0xF)), builder.getInt8Ty());
+    vd = builder.CreateSub(llvm::ConstantDataVector::get(builder.getContext(), indices), builder.CreateVectorSplat(16, sh));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvx(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vd;
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0xFULL));
+    vd = readMemoryVector(addr);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::lvxl(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vd;
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0xFULL));
+    vd = readMemoryVector(addr);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::mfvscr(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::mtvscr(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stvebx(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vs = getVR_u8(code.vs);
+    llvm::Value* element;
+
+    element = builder.CreateSub(builder.getInt64(15), builder.CreateAnd(addr, builder.getInt64(0xF)));
+    writeMemory(addr, builder.CreateExtractElement(vs, element));
 }
 
 void Recompiler::stvehx(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vs = getVR_u16(code.vs);
+    llvm::Value* element;
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0x1ULL));
+    element = builder.CreateSub(builder.getInt64(7), builder.CreateLShr(builder.CreateAnd(addr, builder.getInt64(0xF)), 1));
+    writeMemory(addr, builder.CreateExtractElement(vs, element));
 }
 
 void Recompiler::stvewx(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vs = getVR_u32(code.vs);
+    llvm::Value* element;
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0x3ULL));
+    element = builder.CreateSub(builder.getInt64(3), builder.CreateLShr(builder.CreateAnd(addr, builder.getInt64(0xF)), 2));
+    writeMemory(addr, builder.CreateExtractElement(vs, element));
 }
 
 void Recompiler::stvlx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stvlxl(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stvrx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stvrxl(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::stvx(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vs = getVR_u8(code.vs);
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0xFULL));
+    writeMemoryVector(addr, vs);
 }
 
 void Recompiler::stvxl(Instruction code)
 {
+    llvm::Value* addr = getVectorAddress(code);
+    llvm::Value* vs = getVR_u8(code.vs);
+
+    addr = builder.CreateAnd(addr, builder.getInt64(~0xFULL));
+    writeMemoryVector(addr, vs);
 }
 
 void Recompiler::vaddcuw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateICmpULT(builder.CreateNot(va), vb);
+    vd = builder.CreateZExt(vd, va->getType());
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vaddfp(Instruction code)
@@ -133,9 +242,9 @@ void Recompiler::vaddsbs(Instruction code)
 {
     llvm::Value* va = getVR_u8(code.va);
     llvm::Value* vb = getVR_u8(code.vb);
-    llvm::Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    llvm::Value* vd;
 
-    // TODO: ?
+    vd = createSaturatingAdd(va, vb, true);
 
     setVR(code.vd, vd);
 }
@@ -144,9 +253,9 @@ void Recompiler::vaddshs(Instruction code)
 {
     llvm::Value* va = getVR_u16(code.va);
     llvm::Value* vb = getVR_u16(code.vb);
-    llvm::Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    llvm::Value* vd;
 
-    // TODO: ?
+    vd = createSaturatingAdd(va, vb, true);
 
     setVR(code.vd, vd);
 }
@@ -155,9 +264,9 @@ void Recompiler::vaddsws(Instruction code)
 {
     llvm::Value* va = getVR_u32(code.va);
     llvm::Value* vb = getVR_u32(code.vb);
-    llvm::Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    llvm::Value* vd;
 
-    // TODO: ?
+    vd = createSaturatingAdd(va, vb, true);
 
     setVR(code.vd, vd);
 }
@@ -177,9 +286,9 @@ void Recompiler::vaddubs(Instruction code)
 {
     llvm::Value* va = getVR_u8(code.va);
     llvm::Value* vb = getVR_u8(code.vb);
-    llvm::Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    llvm::Value* vd;
 
-    // TODO: ?
+    vd = createSaturatingAdd(va, vb, false);
 
     setVR(code.vd, vd);
 }
@@ -199,9 +308,9 @@ void Recompiler::vadduhs(Instruction code)
 {
     llvm::Value* va = getVR_u16(code.va);
     llvm::Value* vb = getVR_u16(code.vb);
-    llvm::Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    llvm::Value* vd;
 
-    // TODO: ?
+    vd = createSaturatingAdd(va, vb, false);
 
     setVR(code.vd, vd);
 }
@@ -221,9 +330,9 @@ void Recompiler::vadduws(Instruction code)
 {
     llvm::Value* va = getVR_u32(code.va);
     llvm::Value* vb = getVR_u32(code.vb);
-    llvm::Value* vd = va; // TODO: This is wrong. Just a temporary fix
+    llvm::Value* vd;
 
-    // TODO: ?
+    vd = createSaturatingAdd(va, vb, false);
 
     setVR(code.vd, vd);
 }
@@ -253,44 +362,100 @@ void Recompiler::vandc(Instruction code)
 
 void Recompiler::vavgsb(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = createAverage(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vavgsh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = createAverage(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vavgsw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = createAverage(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vavgub(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = createAverage(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vavguh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = createAverage(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vavguw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = createAverage(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vcfsx(Instruction code)
 {
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSIToFP(vb, llvm::VectorType::get(builder.getFloatTy(), 4));
+    vd = builder.CreateFDiv(vd, llvm::ConstantFP::get(vd->getType(), (double)(1 << code.vuimm)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vcfux(Instruction code)
 {
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateUIToFP(vb, llvm::VectorType::get(builder.getFloatTy(), 4));
+    vd = builder.CreateFDiv(vd, llvm::ConstantFP::get(vd->getType(), (double)(1 << code.vuimm)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vcmpbfp(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpbfp_(Instruction code)
 {
-    vcmpbfp(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpeqfp(Instruction code)
@@ -307,8 +472,7 @@ void Recompiler::vcmpeqfp(Instruction code)
 
 void Recompiler::vcmpeqfp_(Instruction code)
 {
-    vcmpeqfp(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpequb(Instruction code)
@@ -325,8 +489,7 @@ void Recompiler::vcmpequb(Instruction code)
 
 void Recompiler::vcmpequb_(Instruction code)
 {
-    vcmpequb(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpequh(Instruction code)
@@ -343,8 +506,7 @@ void Recompiler::vcmpequh(Instruction code)
 
 void Recompiler::vcmpequh_(Instruction code)
 {
-    vcmpequh(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpequw(Instruction code)
@@ -361,8 +523,7 @@ void Recompiler::vcmpequw(Instruction code)
 
 void Recompiler::vcmpequw_(Instruction code)
 {
-    vcmpequw(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpgefp(Instruction code)
@@ -379,8 +540,7 @@ void Recompiler::vcmpgefp(Instruction code)
 
 void Recompiler::vcmpgefp_(Instruction code)
 {
-    vcmpgefp(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpgtfp(Instruction code)
@@ -397,8 +557,7 @@ void Recompiler::vcmpgtfp(Instruction code)
 
 void Recompiler::vcmpgtfp_(Instruction code)
 {
-    vcmpgtfp(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpgtsb(Instruction code)
@@ -415,8 +574,7 @@ void Recompiler::vcmpgtsb(Instruction code)
 
 void Recompiler::vcmpgtsb_(Instruction code)
 {
-    vcmpgtsb(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpgtsh(Instruction code)
@@ -433,8 +591,7 @@ void Recompiler::vcmpgtsh(Instruction code)
 
 void Recompiler::vcmpgtsh_(Instruction code)
 {
-    vcmpgtsh(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpgtsw(Instruction code)
@@ -451,8 +608,7 @@ void Recompiler::vcmpgtsw(Instruction code)
 
 void Recompiler::vcmpgtsw_(Instruction code)
 {
-    vcmpgtsw(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpgtub(Instruction code)
@@ -469,8 +625,7 @@ void Recompiler::vcmpgtub(Instruction code)
 
 void Recompiler::vcmpgtub_(Instruction code)
 {
-    vcmpgtub(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpgtuh(Instruction code)
@@ -487,8 +642,7 @@ void Recompiler::vcmpgtuh(Instruction code)
 
 void Recompiler::vcmpgtuh_(Instruction code)
 {
-    vcmpgtuh(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vcmpgtuw(Instruction code)
@@ -505,38 +659,27 @@ void Recompiler::vcmpgtuw(Instruction code)
 
 void Recompiler::vcmpgtuw_(Instruction code)
 {
-    vcmpgtuw(code);
-    // TODO: CR6 update
+    createInterpreterFallback();
 }
 
 void Recompiler::vctsxs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vctuxs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vexptefp(Instruction code)
 {
-    llvm::Value* vb = getVR_f32(code.vb);
-    llvm::Value* vd = vb; // TODO: This is wrong. Just a temporary fix
-
-    //llvm::Function* exp2 = getIntrinsicFloat(llvm::Intrinsic::exp2); // TODO: Get a 4xf32 intrinsic instead
-    //vd = builder.CreateCall(exp2, vb);
-
-    setVR(code.vd, vd);
+    createInterpreterFallback();
 }
 
 void Recompiler::vlogefp(Instruction code)
 {
-    llvm::Value* vb = getVR_f32(code.vb);
-    llvm::Value* vd = vb; // TODO: This is wrong. Just a temporary fix
-
-    //llvm::Function* log2 = getIntrinsicFloat(llvm::Intrinsic::log2); // TODO: Get a 4xf32 intrinsic instead
-    //vd = builder.CreateCall(log2, vb);
-
-    setVR(code.vd, vd);
+    createInterpreterFallback();
 }
 
 void Recompiler::vmaddfp(Instruction code)
@@ -546,158 +689,388 @@ void Recompiler::vmaddfp(Instruction code)
     llvm::Value* vb = getVR_f32(code.vb);
     llvm::Value* vd;
 
+    // NOTE: The product is rounded before the addition, as done by the interpreter
     vd = builder.CreateFMul(va, vc);
-    vd = builder.CreateAdd(vd, vb);
+    vd = builder.CreateFAdd(vd, vb);
 
     setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxfp(Instruction code)
 {
+    llvm::Value* va = getVR_f32(code.va);
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateFCmpOLT(va, vb), vb, va);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxsb(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpSGT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxsh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpSGT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxsw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpSGT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxub(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpUGT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxuh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpUGT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmaxuw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpUGT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmhaddshs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vmhraddshs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vminfp(Instruction code)
 {
+    llvm::Value* va = getVR_f32(code.va);
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateFCmpOLT(vb, va), vb, va);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminsb(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpSLT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminsh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpSLT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminsw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpSLT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminub(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpULT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminuh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpULT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vminuw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSelect(builder.CreateICmpULT(va, vb), va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmladduhm(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vc = getVR_u16(code.vc);
+    llvm::Value* vd;
+
+    vd = builder.CreateMul(va, vb);
+    vd = builder.CreateAdd(vd, vc);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrghb(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = createMerge(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrghh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = createMerge(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrghw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = createMerge(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrglb(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = createMerge(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrglh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = createMerge(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmrglw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = createMerge(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmsummbm(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vmsumshm(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vmsumshs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vmsumubm(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vmsumuhm(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vmsumuhs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vmulesb(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    va = builder.CreateAShr(va, 8);
+    vb = builder.CreateAShr(vb, 8);
+    vd = builder.CreateMul(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulesh(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    va = builder.CreateAShr(va, 16);
+    vb = builder.CreateAShr(vb, 16);
+    vd = builder.CreateMul(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmuleub(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    va = builder.CreateLShr(va, 8);
+    vb = builder.CreateLShr(vb, 8);
+    vd = builder.CreateMul(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmuleuh(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    va = builder.CreateLShr(va, 16);
+    vb = builder.CreateLShr(vb, 16);
+    vd = builder.CreateMul(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulosb(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    va = builder.CreateAShr(builder.CreateShl(va, 8), 8);
+    vb = builder.CreateAShr(builder.CreateShl(vb, 8), 8);
+    vd = builder.CreateMul(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulosh(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    va = builder.CreateAShr(builder.CreateShl(va, 16), 16);
+    vb = builder.CreateAShr(builder.CreateShl(vb, 16), 16);
+    vd = builder.CreateMul(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmuloub(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    va = builder.CreateAnd(va, llvm::ConstantInt::get(va->getType(), 0xFF));
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 0xFF));
+    vd = builder.CreateMul(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vmulouh(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    va = builder.CreateAnd(va, llvm::ConstantInt::get(va->getType(), 0xFFFF));
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 0xFFFF));
+    vd = builder.CreateMul(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vnmsubfp(Instruction code)
@@ -707,9 +1080,10 @@ void Recompiler::vnmsubfp(Instruction code)
     llvm::Value* vb = getVR_f32(code.vb);
     llvm::Value* vd;
 
-    // NOTE: vb-(va*vc) = -((va*vc)-vb)
+    // NOTE: -((va*vc)-vb) differs from vb-(va*vc) in the sign of zero results
     vd = builder.CreateFMul(va, vc);
-    vd = builder.CreateSub(vb, vd);
+    vd = builder.CreateFSub(vd, vb);
+    vd = builder.CreateFNeg(vd);
 
     setVR(code.vd, vd);
 }
@@ -739,250 +1113,576 @@ void Recompiler::vor(Instruction code)
 
 void Recompiler::vperm(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vc = getVR_u8(code.vc);
+    llvm::Value* vd;
+
+    vd = createVectorPermute(va, vb, vc);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkpx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vpkshss(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vpkshus(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vpkswss(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vpkswus(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vpkuhum(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    // Low halves of the elements of vA:vB in guest order, taken from vB:vA in host order
+    std::vector<u32> mask;
+    for (u32 i = 0; i < 16; i++) {
+        mask.push_back(2 * i);
+    }
+    vd = builder.CreateShuffleVector(vb, va, getShuffleMask(mask));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkuhus(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vpkuwum(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    // Low halves of the elements of vA:vB in guest order, taken from vB:vA in host order
+    std::vector<u32> mask;
+    for (u32 i = 0; i < 8; i++) {
+        mask.push_back(2 * i);
+    }
+    vd = builder.CreateShuffleVector(vb, va, getShuffleMask(mask));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vpkuwus(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vrefp(Instruction code)
 {
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateFDiv(llvm::ConstantFP::get(vb->getType(), 1.0), vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrfim(Instruction code)
 {
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    llvm::Function* floor = llvm::Intrinsic::getDeclaration(partition->module, llvm::Intrinsic::floor, vb->getType());
+    vd = builder.CreateCall(floor, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrfin(Instruction code)
 {
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    // NOTE: Halfway cases are rounded up, as done by the interpreter
+    llvm::Function* floor = llvm::Intrinsic::getDeclaration(partition->module, llvm::Intrinsic::floor, vb->getType());
+    vd = builder.CreateCall(floor, builder.CreateFAdd(vb, llvm::ConstantFP::get(vb->getType(), 0.5)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrfip(Instruction code)
 {
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    llvm::Function* ceil = llvm::Intrinsic::getDeclaration(partition->module, llvm::Intrinsic::ceil, vb->getType());
+    vd = builder.CreateCall(ceil, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrfiz(Instruction code)
 {
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    llvm::Function* trunc = llvm::Intrinsic::getDeclaration(partition->module, llvm::Intrinsic::trunc, vb->getType());
+    vd = builder.CreateCall(trunc, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrlb(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    llvm::Value* mask = llvm::ConstantInt::get(vb->getType(), 7);
+    vb = builder.CreateAnd(vb, mask);
+    vd = builder.CreateOr(builder.CreateShl(va, vb), builder.CreateLShr(va, builder.CreateAnd(builder.CreateNeg(vb), mask)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrlh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    llvm::Value* mask = llvm::ConstantInt::get(vb->getType(), 15);
+    vb = builder.CreateAnd(vb, mask);
+    vd = builder.CreateOr(builder.CreateShl(va, vb), builder.CreateLShr(va, builder.CreateAnd(builder.CreateNeg(vb), mask)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrlw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    llvm::Value* mask = llvm::ConstantInt::get(vb->getType(), 31);
+    vb = builder.CreateAnd(vb, mask);
+    vd = builder.CreateOr(builder.CreateShl(va, vb), builder.CreateLShr(va, builder.CreateAnd(builder.CreateNeg(vb), mask)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vrsqrtefp(Instruction code)
 {
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    llvm::Function* sqrt = llvm::Intrinsic::getDeclaration(partition->module, llvm::Intrinsic::sqrt, vb->getType());
+    vd = builder.CreateFDiv(llvm::ConstantFP::get(vb->getType(), 1.0), builder.CreateCall(sqrt, vb));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsel(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vc = getVR_u32(code.vc);
+    llvm::Value* vd;
+
+    vd = builder.CreateOr(builder.CreateAnd(vb, vc), builder.CreateAnd(va, builder.CreateNot(vc)));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsl(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vslb(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 7));
+    vd = builder.CreateShl(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsldoi(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    // Bytes sh to sh+15 of vA:vB in guest order, taken from vB:vA in host order
+    std::vector<u32> mask;
+    for (u32 i = 0; i < 16; i++) {
+        mask.push_back(16 + i - code.vshb);
+    }
+    vd = builder.CreateShuffleVector(vb, va, getShuffleMask(mask));
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vslh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 15));
+    vd = builder.CreateShl(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vslo(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vslw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 31));
+    vd = builder.CreateShl(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltb(Instruction code)
 {
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = createSplat(vb, code.vuimm);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsplth(Instruction code)
 {
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = createSplat(vb, code.vuimm);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltisb(Instruction code)
 {
+    llvm::Value* vd;
+
+    vd = llvm::ConstantInt::get(llvm::VectorType::get(builder.getInt8Ty(), 16), (s64)code.vsimm, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltish(Instruction code)
 {
+    llvm::Value* vd;
+
+    vd = llvm::ConstantInt::get(llvm::VectorType::get(builder.getInt16Ty(), 8), (s64)code.vsimm, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltisw(Instruction code)
 {
+    llvm::Value* vd;
+
+    vd = llvm::ConstantInt::get(llvm::VectorType::get(builder.getInt32Ty(), 4), (s64)code.vsimm, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vspltw(Instruction code)
 {
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = createSplat(vb, code.vuimm);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsr(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vsrab(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 7));
+    vd = builder.CreateAShr(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsrah(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 15));
+    vd = builder.CreateAShr(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsraw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 31));
+    vd = builder.CreateAShr(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsrb(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 7));
+    vd = builder.CreateLShr(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsrh(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 15));
+    vd = builder.CreateLShr(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsro(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vsrw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vb = builder.CreateAnd(vb, llvm::ConstantInt::get(vb->getType(), 31));
+    vd = builder.CreateLShr(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubcuw(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateICmpUGE(va, vb);
+    vd = builder.CreateZExt(vd, va->getType());
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubfp(Instruction code)
 {
+    llvm::Value* va = getVR_f32(code.va);
+    llvm::Value* vb = getVR_f32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateFSub(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubsbs(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = createSaturatingSub(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubshs(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = createSaturatingSub(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubsws(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = createSaturatingSub(va, vb, true);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsububm(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSub(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsububs(Instruction code)
 {
+    llvm::Value* va = getVR_u8(code.va);
+    llvm::Value* vb = getVR_u8(code.vb);
+    llvm::Value* vd;
+
+    vd = createSaturatingSub(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubuhm(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSub(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubuhs(Instruction code)
 {
+    llvm::Value* va = getVR_u16(code.va);
+    llvm::Value* vb = getVR_u16(code.vb);
+    llvm::Value* vd;
+
+    vd = createSaturatingSub(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubuwm(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = builder.CreateSub(va, vb);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsubuws(Instruction code)
 {
+    llvm::Value* va = getVR_u32(code.va);
+    llvm::Value* vb = getVR_u32(code.vb);
+    llvm::Value* vd;
+
+    vd = createSaturatingSub(va, vb, false);
+
+    setVR(code.vd, vd);
 }
 
 void Recompiler::vsum2sws(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vsum4sbs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vsum4shs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vsum4ubs(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vsumsws(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vupkhpx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vupkhsb(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vupkhsh(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vupklpx(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vupklsb(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vupklsh(Instruction code)
 {
+    createInterpreterFallback();
 }
 
 void Recompiler::vxor(Instruction code)
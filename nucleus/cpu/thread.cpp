@@ -9,5 +9,7 @@
 
 void CellThread::join()
 {
-    m_thread->join();
+    if (m_thread && m_thread->joinable()) {
+        m_thread->join();
+    }
 }
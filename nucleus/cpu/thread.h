@@ -7,6 +7,7 @@
 
 #include "nucleus/common.h"
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <string>
@@ -27,7 +28,7 @@ protected:
     std::string m_name;
     std::thread* m_thread = nullptr;
 
-    EmulatorEvent m_event = NUCLEUS_EVENT_NONE;
+    std::atomic<EmulatorEvent> m_event{NUCLEUS_EVENT_NONE};
     EmulatorStatus m_status = NUCLEUS_STATUS_UNKNOWN;
 
 public:
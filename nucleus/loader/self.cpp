@@ -52,6 +52,7 @@ bool SELFLoader::load_elf(sys_process_t& proc)
     }
 
     const auto& ehdr = (Elf64_Ehdr&)elf[0];
+    std::vector<const Elf64_Phdr*> executable;
 
     // Loading program header table
     for (u64 i = 0; i < ehdr.phnum; i++) {
@@ -65,11 +66,8 @@ bool SELFLoader::load_elf(sys_process_t& proc)
 
             nucleus.memory(SEG_MAIN_MEMORY).allocFixed(phdr.vaddr, phdr.memsz);
             memcpy(nucleus.memory.ptr(phdr.vaddr), &elf[phdr.offset], phdr.filesz);
-            if ((phdr.flags & PF_X) && config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
-                auto segment = new cpu::ppu::Segment(phdr.vaddr, phdr.filesz);
-                segment->analyze();
-                segment->recompile();
-                nucleus.cell.ppu_segments.push_back(segment);
+            if (phdr.flags & PF_X) {
+                executable.push_back(&phdr);
             }
             break;
 
@@ -95,6 +93,28 @@ bool SELFLoader::load_elf(sys_process_t& proc)
             break;
         }
     }
+
+    // Recompile executable segments once every segment is loaded, since the TOC base is read from the entry descriptor
+    const u32 toc = nucleus.memory.read32(ehdr.entry + 4);
+    for (const auto* phdr : executable) {
+        if (config.ppuTranslator == PPU_TRANSLATOR_TIERED) {
+            auto segment = new cpu::ppu::Segment(phdr->vaddr, phdr->filesz, toc);
+            segment->analyze();
+            nucleus.cell.addSegment(segment);
+            nucleus.cell.ppu_tiering.addSegment(segment);
+        }
+        if (config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
+            auto segment = new cpu::ppu::Segment(phdr->vaddr, phdr->filesz, toc);
+            if (!segment->load()) {
+                segment->analyze();
+                segment->recompile();
+            }
+            nucleus.cell.addSegment(segment);
+        }
+    }
+
+    // Calls to modules loaded before the executable are linked directly
+    nucleus.cell.linkImports();
     return true;
 }
 
@@ -132,6 +152,7 @@ bool SELFLoader::load_prx(sys_prx_t& prx)
                 const auto& module = (sys_prx_module_info_t&)elf[phdr.paddr];
                 prx.name = module.name;
                 prx.version = module.version;
+                prx.toc = module.toc;
 
                 // Get FNID / addr pairs
                 u32 offset = module.exports_start;
@@ -269,15 +290,34 @@ bool SELFLoader::load_prx(sys_prx_t& prx)
         }
     }
 
+    // Relocate the TOC base, which points 32 KB past the start of the TOC
+    u32 toc = 0;
+    for (const auto& segment : prx.segments) {
+        if (prx.toc && segment.initial_addr <= prx.toc - 0x8000 && prx.toc - 0x8000 < segment.initial_addr + segment.size_memory) {
+            toc = prx.toc + (segment.addr - segment.initial_addr);
+        }
+    }
+
     // Recompile executable segments
     for (auto& prx_segment : prx.segments) {
-        if ((prx_segment.flags & PF_X) && config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
-            auto segment = new cpu::ppu::Segment(prx_segment.addr, prx_segment.size_file);
+        if ((prx_segment.flags & PF_X) && config.ppuTranslator == PPU_TRANSLATOR_TIERED) {
+            auto segment = new cpu::ppu::Segment(prx_segment.addr, prx_segment.size_file, toc);
             segment->analyze();
-            segment->recompile();
-            nucleus.cell.ppu_segments.push_back(segment);
+            nucleus.cell.addSegment(segment);
+            nucleus.cell.ppu_tiering.addSegment(segment);
+        }
+        if ((prx_segment.flags & PF_X) && config.ppuTranslator == PPU_TRANSLATOR_RECOMPILER) {
+            auto segment = new cpu::ppu::Segment(prx_segment.addr, prx_segment.size_file, toc);
+            if (!segment->load()) {
+                segment->analyze();
+                segment->recompile();
+            }
+            nucleus.cell.addSegment(segment);
         }
     }
+
+    // Calls between the new module and the modules already loaded are linked directly
+    nucleus.cell.linkImports();
     return true;
 }
 
@@ -7,6 +7,8 @@
 #include "nucleus/common.h"
 #include "nucleus/emulator.h"
 
+#include <chrono>
+
 #ifdef NUCLEUS_PLATFORM_WINDOWS
 #include <Windows.h>
 #endif
@@ -32,6 +34,10 @@ void Memory::init()
         nucleus.log.error(LOG_MEMORY, "Could not reserve memory");
     }
 
+    // Initialize page flags
+    m_pageFlags = new std::atomic<u8>[0x100000]();
+    reservations.init();
+
     // Initialize segments
     m_segments[SEG_MAIN_MEMORY].init(0x00010000, 0x2FFF0000);
     m_segments[SEG_USER_MEMORY].init(0x10000000, 0x10000000);
@@ -50,6 +56,8 @@ void Memory::close()
 #endif
         nucleus.log.error(LOG_MEMORY, "Could not release memory");
     }
+    delete[] m_pageFlags;
+    reservations.close();
 }
 
 u32 Memory::alloc(u32 size, u32 align)
@@ -67,6 +75,64 @@ bool Memory::check(u32 addr)
     return true;
 }
 
+/**
+ * Page flags
+ */
+u8 Memory::getPageFlags(u32 addr)
+{
+    return m_pageFlags[addr >> 12].load();
+}
+void Memory::setPageFlags(u32 addr, u8 flags)
+{
+    m_pageFlags[addr >> 12].fetch_or(flags);
+}
+void Memory::clearPageFlags(u32 addr, u8 flags)
+{
+    m_pageFlags[addr >> 12].fetch_and(~flags);
+}
+void Memory::onWrite(u32 addr, u32 size)
+{
+    const u32 first = addr >> 12;
+    const u32 last = (addr + size - 1) >> 12;
+    for (u32 page = first; page <= last; page++) {
+        const u32 pageAddr = page << 12;
+        const u8 flags = m_pageFlags[page].load();
+
+        // Self-modifying code: Discard predecoded instructions
+        if (flags & PAGE_CODE) {
+            clearPageFlags(pageAddr, PAGE_CODE);
+            nucleus.cell.ppu_icache.invalidate(pageAddr);
+        }
+        // Break reservations on the written granules
+        if (flags & PAGE_RESERVED) {
+            reservations.notify(addr, size);
+        }
+        // Wake up threads polling this page
+        if (flags & PAGE_WAIT) {
+            clearPageFlags(pageAddr, PAGE_WAIT);
+            WaitBucket& bucket = m_waitBuckets[page % WAIT_BUCKET_COUNT];
+            std::lock_guard<std::mutex> lock(bucket.mutex);
+            bucket.cv.notify_all();
+        }
+    }
+}
+
+void Memory::waitWrite(u32 addr, u32 expected, u32 timeout)
+{
+    WaitBucket& bucket = m_waitBuckets[(addr >> 12) % WAIT_BUCKET_COUNT];
+    std::unique_lock<std::mutex> lock(bucket.mutex);
+
+    // Writers check the page flags after storing the value, so check it again after setting them.
+    // Writes racing with this check, or through pointers that bypass the page flags, are covered
+    // by the timeout.
+    setPageFlags(addr, PAGE_WAIT);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (read32(addr) != expected) {
+        return;
+    }
+    bucket.cv.wait_for(lock, std::chrono::microseconds(timeout));
+}
+
 /**
  * Read memory reversing endianness if necessary
  */
@@ -109,22 +175,27 @@ void Memory::readRight(u8* dst, u32 src, u32 size)
 void Memory::write8(u32 addr, u8 value)
 {
     *(u8*)((u64)m_base + addr) = value;
+    checkWrite(addr, 1);
 }
 void Memory::write16(u32 addr, u16 value)
 {
     *(u16*)((u64)m_base + addr) = re16(value);
+    checkWrite(addr, 2);
 }
 void Memory::write32(u32 addr, u32 value)
 {
     *(u32*)((u64)m_base + addr) = re32(value);
+    checkWrite(addr, 4);
 }
 void Memory::write64(u32 addr, u64 value)
 {
     *(u64*)((u64)m_base + addr) = re64(value);
+    checkWrite(addr, 8);
 }
 void Memory::write128(u32 addr, u128 value)
 {
     *(u128*)((u64)m_base + addr) = re128(value);
+    checkWrite(addr, 16);
 }
 void Memory::writeLeft(u32 dst, u8* src, u32 size)
 {
@@ -6,8 +6,13 @@
 #pragma once
 
 #include "nucleus/common.h"
+#include "reservation.h"
 #include "segment.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 enum
 {
     // Memory segments
@@ -22,12 +27,36 @@ enum
     SEG_COUNT,
 };
 
+enum
+{
+    // Page flags (4 KB granularity)
+    PAGE_CODE     = (1 << 0),  // Page is predecoded by the PPU interpreter
+    PAGE_RESERVED = (1 << 1),  // Page contains granules reserved by load-and-reserve instructions
+    PAGE_WAIT     = (1 << 2),  // Page is polled by threads waiting for it to be written
+};
+
 class Memory
 {
     void* m_base;
     MemorySegment m_segments[SEG_COUNT];
 
+    // Flags of each 4 KB page, checked on every write
+    std::atomic<u8>* m_pageFlags;
+
+    // Threads waiting for writes, hashed by page
+    static const u32 WAIT_BUCKET_COUNT = 64;
+    struct WaitBucket
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+    } m_waitBuckets[WAIT_BUCKET_COUNT];
+
+    void onWrite(u32 addr, u32 size);
+
 public:
+    // Reservations of load-and-reserve and store-conditional instructions
+    Reservations reservations;
+
     void init();
     void close();
 
@@ -53,6 +82,24 @@ public:
 
     void* getBaseAddr() { return m_base; }
 
+    // Page flags
+    u8 getPageFlags(u32 addr);
+    void setPageFlags(u32 addr, u8 flags);
+    void clearPageFlags(u32 addr, u8 flags);
+
+    // Block the caller until the page containing the address is written, the 32-bit word at
+    // that address stops holding the expected value, or the timeout (in microseconds) expires
+    void waitWrite(u32 addr, u32 expected, u32 timeout);
+
+    // Handle page flags after writing guest memory (required when writing through raw pointers)
+    void checkWrite(u32 addr, u32 size) {
+        const u32 first = addr >> 12;
+        const u32 last = (addr + size - 1) >> 12;
+        if (m_pageFlags[first].load(std::memory_order_relaxed) | m_pageFlags[last].load(std::memory_order_relaxed)) {
+            onWrite(addr, size);
+        }
+    }
+
     MemorySegment& operator()(size_t id) { return m_segments[id]; }
 
     template<typename T>
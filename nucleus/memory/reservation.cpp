@@ -0,0 +1,169 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#include "reservation.h"
+#include "nucleus/emulator.h"
+
+#include <thread>
+
+// Access guest memory atomically
+template <typename T>
+static std::atomic<T>& atomicRef(u32 addr)
+{
+    return *nucleus.memory.ptr<std::atomic<T>>(addr);
+}
+
+void Reservations::init()
+{
+    if (!m_slots) {
+        m_slots = new Slot[SLOT_COUNT]();
+        m_pageCounts = new std::atomic<u32>[0x100000]();
+    }
+}
+
+void Reservations::close()
+{
+    delete[] m_slots;
+    delete[] m_pageCounts;
+    m_slots = nullptr;
+    m_pageCounts = nullptr;
+}
+
+u64 Reservations::acquire(u32 addr)
+{
+    std::atomic<u64>& version = getVersion(addr);
+    u64 current = version.load(std::memory_order_acquire);
+    while (current & 1) {
+        std::this_thread::yield();
+        current = version.load(std::memory_order_acquire);
+    }
+    return current;
+}
+
+bool Reservations::lock(u32 addr, u64 version)
+{
+    return getVersion(addr).compare_exchange_strong(version, version + 1, std::memory_order_acq_rel);
+}
+
+void Reservations::unlock(u32 addr)
+{
+    getVersion(addr).fetch_add(1, std::memory_order_release);
+}
+
+void Reservations::reserve(Reservation& reservation, u32 addr)
+{
+    release(reservation);
+
+    // Plain stores to this page will invalidate reservations from now on
+    if (m_pageCounts[addr >> 12].fetch_add(1) == 0) {
+        nucleus.memory.setPageFlags(addr, PAGE_RESERVED);
+    }
+    reservation.addr = addr;
+    reservation.active = true;
+}
+
+void Reservations::release(Reservation& reservation)
+{
+    if (!reservation.active) {
+        return;
+    }
+    reservation.active = false;
+    if (!m_pageCounts) {
+        return;
+    }
+
+    // Another thread might reserve the page while the flag is cleared, so check the count again
+    std::atomic<u32>& count = m_pageCounts[reservation.addr >> 12];
+    if (count.fetch_sub(1) == 1) {
+        nucleus.memory.clearPageFlags(reservation.addr, PAGE_RESERVED);
+        if (count.load() != 0) {
+            nucleus.memory.setPageFlags(reservation.addr, PAGE_RESERVED);
+        }
+    }
+}
+
+void Reservations::notify(u32 addr, u32 size)
+{
+    const u32 first = addr >> GRANULE_SHIFT;
+    const u32 last = (addr + size - 1) >> GRANULE_SHIFT;
+    for (u32 granule = first; granule <= last; granule++) {
+        // Keeps the parity, so it does not interfere with locked slots
+        getVersion(granule << GRANULE_SHIFT).fetch_add(2, std::memory_order_release);
+    }
+}
+
+u32 Reservations::load32(Reservation& reservation, u32 addr)
+{
+    reserve(reservation, addr);
+    reservation.version = acquire(addr);
+    reservation.value = atomicRef<u32>(addr).load(std::memory_order_acquire);
+    return re32((u32)reservation.value);
+}
+
+u64 Reservations::load64(Reservation& reservation, u32 addr)
+{
+    reserve(reservation, addr);
+    reservation.version = acquire(addr);
+    reservation.value = atomicRef<u64>(addr).load(std::memory_order_acquire);
+    return re64(reservation.value);
+}
+
+bool Reservations::store32(Reservation& reservation, u32 addr, u32 value)
+{
+    const bool reserved = reservation.active && reservation.addr == addr;
+    release(reservation);
+    if (!reserved || !lock(addr, reservation.version)) {
+        return false;
+    }
+
+    // Plain stores bump the version only after writing, so compare the value as well
+    u32 expected = (u32)reservation.value;
+    const bool success = atomicRef<u32>(addr).compare_exchange_strong(expected, re32(value));
+    unlock(addr);
+    if (success) {
+        nucleus.memory.checkWrite(addr, 4);
+    }
+    return success;
+}
+
+bool Reservations::store64(Reservation& reservation, u32 addr, u64 value)
+{
+    const bool reserved = reservation.active && reservation.addr == addr;
+    release(reservation);
+    if (!reserved || !lock(addr, reservation.version)) {
+        return false;
+    }
+
+    u64 expected = reservation.value;
+    const bool success = atomicRef<u64>(addr).compare_exchange_strong(expected, re64(value));
+    unlock(addr);
+    if (success) {
+        nucleus.memory.checkWrite(addr, 8);
+    }
+    return success;
+}
+
+/**
+ * Recompiler utilities
+ */
+u32 reservationLoad32(Reservation* reservation, u32 addr)
+{
+    return nucleus.memory.reservations.load32(*reservation, addr);
+}
+
+u64 reservationLoad64(Reservation* reservation, u32 addr)
+{
+    return nucleus.memory.reservations.load64(*reservation, addr);
+}
+
+u32 reservationStore32(Reservation* reservation, u32 addr, u32 value)
+{
+    return nucleus.memory.reservations.store32(*reservation, addr, value);
+}
+
+u32 reservationStore64(Reservation* reservation, u32 addr, u64 value)
+{
+    return nucleus.memory.reservations.store64(*reservation, addr, value);
+}
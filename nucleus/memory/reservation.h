@@ -0,0 +1,92 @@
+/**
+ * (c) 2015 Nucleus project. All rights reserved.
+ * Released under GPL v2 license. Read LICENSE for more details.
+ */
+
+#pragma once
+
+#include "nucleus/common.h"
+
+#include <atomic>
+
+/**
+ * Reservation held by a thread after a load-and-reserve instruction
+ */
+struct Reservation
+{
+    u64 version;    // Version of the granule when the reservation was acquired
+    u64 value;      // Value loaded from memory (guest endianness)
+    u32 addr;       // Reserved address
+    bool active;    // Reservation was acquired and not yet consumed
+};
+
+/**
+ * Reservation table:
+ * Memory is split in granules of 128 bytes, hashed into a fixed number of slots, each one
+ * holding a version counter. Load-and-reserve instructions remember the version of the granule,
+ * store-conditional instructions lock the slot by incrementing it to an odd value if it did not
+ * change, and unlock it afterwards. Plain stores to pages holding reservations bump the version,
+ * which makes any reservation on that granule fail. Stores bypassing the page flags are only caught
+ * by comparing the reserved value, so one writing back the same value goes unnoticed (ABA).
+ * Slots are padded to a cache line, so threads working on different granules do not contend.
+ * Granules sharing a slot might cause spurious failures, which the architecture allows.
+ * Pages are flagged as long as they hold active reservations, so other pages skip the notifications.
+ */
+class Reservations
+{
+public:
+    static const u32 GRANULE_SHIFT = 7;
+    static const u32 GRANULE_SIZE = 1 << GRANULE_SHIFT;
+    static const u32 SLOT_COUNT = 1 << 16;
+
+private:
+    struct Slot
+    {
+        std::atomic<u64> version;
+        u8 padding[64 - sizeof(std::atomic<u64>)];
+    };
+
+    Slot* m_slots = nullptr;
+
+    // Active reservations of each 4 KB page
+    std::atomic<u32>* m_pageCounts = nullptr;
+
+    std::atomic<u64>& getVersion(u32 addr) {
+        return m_slots[(addr >> GRANULE_SHIFT) & (SLOT_COUNT - 1)].version;
+    }
+
+    // Get the current version of the granule, waiting for store-conditionals in progress
+    u64 acquire(u32 addr);
+
+    // Lock the granule if its version did not change since it was acquired
+    bool lock(u32 addr, u64 version);
+    void unlock(u32 addr);
+
+    // Track the active reservations of each page, flagging pages that hold any of them
+    void reserve(Reservation& reservation, u32 addr);
+
+public:
+    void init();
+    void close();
+
+    // Drop the reservation, e.g. when the thread holding it is destroyed
+    void release(Reservation& reservation);
+
+    // Invalidate reservations on the granules written by a plain store
+    void notify(u32 addr, u32 size);
+
+    // Load-and-reserve and store-conditional operations (values in host endianness)
+    u32 load32(Reservation& reservation, u32 addr);
+    u64 load64(Reservation& reservation, u32 addr);
+    bool store32(Reservation& reservation, u32 addr, u32 value);
+    bool store64(Reservation& reservation, u32 addr, u64 value);
+};
+
+/**
+ * Recompiler utilities:
+ * Wrappers with a plain signature to be called from recompiled code.
+ */
+u32 reservationLoad32(Reservation* reservation, u32 addr);
+u64 reservationLoad64(Reservation* reservation, u32 addr);
+u32 reservationStore32(Reservation* reservation, u32 addr, u32 value);
+u32 reservationStore64(Reservation* reservation, u32 addr, u64 value);
@@ -100,6 +100,7 @@ LV2::LV2(u32 fw_type)
         m_syscalls[0x1D1] = SYSCALL(sys_prx_load_module_list, LV2_NONE);
         m_syscalls[0x1E0] = SYSCALL(sys_prx_load_module, LV2_NONE);
         m_syscalls[0x1E1] = SYSCALL(sys_prx_start_module, LV2_NONE);
+        m_syscalls[0x1E3] = SYSCALL(sys_prx_unload_module, LV2_NONE);
         m_syscalls[0x1E4] = SYSCALL(sys_prx_register_module, LV2_NONE);
         m_syscalls[0x1E6] = SYSCALL(sys_prx_register_library, LV2_NONE);
         m_syscalls[0x1EE] = SYSCALL(sys_prx_get_module_list, LV2_NONE);
@@ -69,6 +69,8 @@ s32 sys_prx_start_module(s32 id, u64 flags, sys_prx_start_module_option_t* pOpt)
             }
             for (u32 i = 0; i < importedLibrary.num_func; i++) {
                 const u32 fnid = nucleus.memory.read32(importedLibrary.fnid_addr + 4*i);
+                const u32 stubAddr = importedLibrary.fstub_addr + 4*i;
+                prx->linked_stubs.push_back(std::make_pair(stubAddr, nucleus.memory.read32(stubAddr)));
 
                 // Try to link to a native implementation (HLE)
                 if (nucleus.lv2.modules.find(lib.name, fnid)) {
@@ -79,17 +81,22 @@ s32 sys_prx_start_module(s32 id, u64 flags, sys_prx_start_module_option_t* pOpt)
                     nucleus.memory.write32(hookAddr + 12, 0x4E800020);                           // blr
                     nucleus.memory.write32(hookAddr + 16, hookAddr);                             // OPD: Function address
                     nucleus.memory.write32(hookAddr + 20, 0);                                    // OPD: Function RTOC
-                    nucleus.memory.write32(importedLibrary.fstub_addr + 4*i, hookAddr + 16);
+                    nucleus.memory.write32(stubAddr, hookAddr + 16);
+                    prx->hooks.push_back(hookAddr);
                 }
 
                 // Otherwise, link to original function (LLE)
                 else {
-                    nucleus.memory.write32(importedLibrary.fstub_addr + 4*i, lib.exports.at(fnid));
+                    nucleus.memory.write32(stubAddr, lib.exports.at(fnid));
                 }
             }
         }
     }
 
+    // Calls through the import table updated are linked directly to the recompiled code of the module
+    nucleus.cell.linkImports();
+    prx->started = true;
+
     if (prx->func_start) {
         pOpt->entry = prx->func_start;
     } else {
@@ -99,6 +106,43 @@ s32 sys_prx_start_module(s32 id, u64 flags, sys_prx_start_module_option_t* pOpt)
     return CELL_OK;
 }
 
+s32 sys_prx_unload_module(s32 id, u64 flags, sys_prx_unload_module_option_t* pOpt)
+{
+    auto* prx = nucleus.lv2.objects.get<sys_prx_t>(id);
+    if (!prx) {
+        return CELL_PRX_ERROR_UNKNOWN_MODULE;
+    }
+
+    // Stop the module and reset the import table entries linked to it to their previous values
+    if (prx->started) {
+        if (prx->func_stop) {
+            Callback{prx->func_stop}.call();
+        }
+        for (const auto& stub : prx->linked_stubs) {
+            nucleus.memory.write32(stub.first, stub.second);
+        }
+        for (const auto& hookAddr : prx->hooks) {
+            nucleus.memory.free(hookAddr);
+        }
+    }
+
+    // Recompiled code of the module is no longer dispatched to, and calls into it go through the import stubs again
+    for (const auto& segment : prx->segments) {
+        if (segment.flags & PF_X) {
+            nucleus.cell.removeSegment(segment.addr);
+        }
+    }
+    nucleus.cell.linkImports();
+
+    // Release the guest memory of the module
+    for (const auto& segment : prx->segments) {
+        nucleus.memory(SEG_MAIN_MEMORY).free(segment.addr);
+    }
+
+    nucleus.lv2.objects.remove(id);
+    return CELL_OK;
+}
+
 s32 sys_prx_0x1CE()
 {
     return CELL_OK;
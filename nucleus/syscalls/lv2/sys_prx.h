@@ -132,6 +132,7 @@ struct sys_prx_segment_t
 struct sys_prx_t
 {
     u16 version;
+    u32 toc;  // TOC base specified on the module info, before relocation
     u32 func_start;
     u32 func_stop;
     u32 func_exit;
@@ -140,6 +141,11 @@ struct sys_prx_t
     std::vector<sys_prx_library_t> exported_libs;
     std::vector<sys_prx_library_t> imported_libs;
     std::vector<sys_prx_segment_t> segments;
+
+    // Linking status, undone when the module is unloaded
+    bool started = false;
+    std::vector<std::pair<u32, u32>> linked_stubs; // Import table entries updated on start: Address -> Previous value
+    std::vector<u32> hooks;                        // Addresses of the HLE hooks allocated on start
 };
 
 // SysCalls
@@ -7,9 +7,22 @@
 #include "CppUnitTest.h"
 
 // Target
-// TODO
+#include "nucleus/config.h"
+#include "nucleus/emulator.h"
+#include "nucleus/cpu/ppu/ppu_cache.h"
+#include "nucleus/cpu/ppu/ppu_decoder.h"
+#include "nucleus/cpu/ppu/ppu_tables.h"
+#include "nucleus/loader/self.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace cpu::ppu;
 
 TEST_CLASS(PPUTests) {
 
@@ -19,6 +32,126 @@ public:
         // TODO
     }
 
+    TEST_METHOD(PPU_DecoderBenchmark)
+    {
+        // Decrypted executable whose .text section is used as input
+        const char* path = std::getenv("NUCLEUS_TEST_ELF");
+        if (!path) {
+            Logger::WriteMessage("PPU_DecoderBenchmark: Set NUCLEUS_TEST_ELF to run this benchmark");
+            return;
+        }
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> elf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        Assert::IsTrue(elf.size() >= sizeof(Elf64_Ehdr));
+
+        // Find the .text section
+        const auto& ehdr = (Elf64_Ehdr&)elf[0];
+        const auto& shstr = (Elf64_Shdr&)elf[ehdr.shoff + ehdr.shstrndx * sizeof(Elf64_Shdr)];
+        std::vector<Instruction> text;
+        for (u32 i = 0; i < ehdr.shnum; i++) {
+            const auto& shdr = (Elf64_Shdr&)elf[ehdr.shoff + i * sizeof(Elf64_Shdr)];
+            if (!strcmp(&elf[shstr.offset + shdr.name], ".text")) {
+                for (u64 offset = 0; offset < shdr.size; offset += 4) {
+                    text.push_back(Instruction{ ((be_t<u32>&)elf[shdr.offset + offset]).ToLE() });
+                }
+            }
+        }
+        Assert::IsFalse(text.empty());
+
+        // Both decoders must agree
+        for (const auto& code : text) {
+            Assert::IsTrue(get_entry(code).type == get_entry_nested(code).type);
+            Assert::IsTrue(get_entry(code).interpret == get_entry_nested(code).interpret);
+        }
+
+        // Measure both decoders, accumulating the handlers to keep the calls alive
+        auto measure = [&](const Entry& (*decode)(Instruction)) {
+            const auto start = std::chrono::high_resolution_clock::now();
+            uintptr_t checksum = 0;
+            for (int pass = 0; pass < 100; pass++) {
+                for (const auto& code : text) {
+                    checksum += (uintptr_t)decode(code).name;
+                }
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+            Assert::IsTrue(checksum != 1);
+            return std::chrono::duration<double>(end - start).count();
+        };
+        const double timeNested = measure(get_entry_nested);
+        const double timeFlat = measure(get_entry);
+
+        const double decoded = 100.0 * text.size();
+        Logger::WriteMessage(("PPU_DecoderBenchmark: " + std::to_string(text.size()) + " instructions\n").c_str());
+        Logger::WriteMessage(("  Nested tables: " + std::to_string(decoded / timeNested / 1e6) + " M instructions/s\n").c_str());
+        Logger::WriteMessage(("  Flat table:    " + std::to_string(decoded / timeFlat / 1e6) + " M instructions/s\n").c_str());
+    }
+
+    TEST_METHOD(PPU_AnalyzerBenchmark)
+    {
+        // Synthetic 16 MB segment made of small functions with two blocks, each one calling the previous one
+        const u32 size = 16 * 1024 * 1024;
+        const u32 functionInstructions = 11;
+        const u32 functionCount = size / (functionInstructions * 4);
+        nucleus.memory.init();
+        const u32 address = nucleus.memory.alloc(size, 0x10000);
+        Assert::IsTrue(address != 0);
+
+        u32 addr = address;
+        for (u32 i = 0; i < functionCount; i++) {
+            const u32 callee = (i == 0) ? addr : addr - functionInstructions * 4;
+            nucleus.memory.write32(addr + 0x00, 0x7C0802A6); // mflr r0
+            nucleus.memory.write32(addr + 0x04, 0x9421FFE0); // stwu r1, -0x20(r1)
+            nucleus.memory.write32(addr + 0x08, 0x90010024); // stw r0, 0x24(r1)
+            nucleus.memory.write32(addr + 0x0C, 0x2C030000); // cmpwi r3, 0
+            nucleus.memory.write32(addr + 0x10, 0x4182000C); // beq +0xC
+            nucleus.memory.write32(addr + 0x14, 0x3863FFFF); // addi r3, r3, -1
+            nucleus.memory.write32(addr + 0x18, 0x48000001 | ((callee - (addr + 0x18)) & 0x3FFFFFC)); // bl callee
+            nucleus.memory.write32(addr + 0x1C, 0x80010024); // lwz r0, 0x24(r1)
+            nucleus.memory.write32(addr + 0x20, 0x38210020); // addi r1, r1, 0x20
+            nucleus.memory.write32(addr + 0x24, 0x7C0803A6); // mtlr r0
+            nucleus.memory.write32(addr + 0x28, 0x4E800020); // blr
+            addr += functionInstructions * 4;
+        }
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        Segment segment(address, functionCount * functionInstructions * 4);
+        segment.analyze();
+        const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+        Assert::AreEqual<size_t>(functionCount, segment.functions.size());
+        for (const auto& item : segment.functions) {
+            Assert::AreEqual<size_t>(3, item.second.blocks.size());
+        }
+        nucleus.memory.close();
+
+        Logger::WriteMessage(("PPU_AnalyzerBenchmark: " + std::to_string(functionCount) + " functions\n").c_str());
+        Logger::WriteMessage(("  Analysis: " + std::to_string(elapsed.count()) + " s, " + std::to_string(functionCount / elapsed.count()) + " functions/s\n").c_str());
+    }
+
+    TEST_METHOD(PPU_CacheKeyTests)
+    {
+        nucleus.memory.init();
+        const u32 address = nucleus.memory.alloc(0x1000, 0x10000);
+        Assert::IsTrue(address != 0);
+        nucleus.memory.write32(address, 0x4E800020); // blr
+
+        // Same code and settings
+        const bool spinDetection = config.ppuSpinDetection;
+        const u64 key = ObjectCache::getKey(address, 4);
+        Assert::IsTrue(key == ObjectCache::getKey(address, 4));
+
+        // Settings changing the generated code must miss the cache
+        config.ppuSpinDetection = !spinDetection;
+        Assert::IsTrue(key != ObjectCache::getKey(address, 4));
+        config.ppuSpinDetection = spinDetection;
+        Assert::IsTrue(key == ObjectCache::getKey(address, 4));
+
+        // Modified code must miss the cache
+        nucleus.memory.write32(address, 0x60000000); // nop
+        Assert::IsTrue(key != ObjectCache::getKey(address, 4));
+        nucleus.memory.close();
+    }
+
     TEST_METHOD(PPU_InterpreterTests)
     {
         // TODO